@@ -10,7 +10,7 @@ EthernetServer server(80);
 IRsend irsend;
 String HTTP_REQUEST;
 
-unsigned int  rawData[69] = {47536, 4700,4250, 750,1500, 700,1500, 700,1550, 700,400, 700,400, 700,400, 700,450, 650,450, 650,1600, 600,1600, 650,1600, 600,500, 600,500, 600,550, 600,500, 600,500, 600,1650, 550,1650, 600,1650, 550,550, 550,600, 500,600, 500,600, 550,550, 550,600, 500,600, 500,600, 500,1750, 500,1700, 500,1750, 500,1700, 500,1750, 500,0};  // SAMSUNG E0E0E01F
+const unsigned int  rawData[69] PROGMEM = {47536, 4700,4250, 750,1500, 700,1500, 700,1550, 700,400, 700,400, 700,400, 700,450, 650,450, 650,1600, 600,1600, 650,1600, 600,500, 600,500, 600,550, 600,500, 600,500, 600,1650, 550,1650, 600,1650, 550,550, 550,600, 500,600, 500,600, 550,550, 550,600, 500,600, 500,600, 500,1750, 500,1700, 500,1750, 500,1700, 500,1750, 500,0};  // SAMSUNG E0E0E01F
 
 void setup()
 {
@@ -56,10 +56,9 @@ void loop()
           client.println("<form method=\"get\">");
 
           if (HTTP_REQUEST.indexOf("GET /?volume=up HTTP/1.1") > -1) {
-            for (int i = 0; i < 3; i++) {
-              irsend.sendRaw(rawData,69,32);
-              delay(40);
-             }
+            // Sent from the timer interrupt, three times 40 mS apart,
+            // while the page goes out.  rawData stays in flash
+            irsend.sendAsync_P(rawData,69,32,2,40);
             Serial.println("Volume Up by 1");
           }
 
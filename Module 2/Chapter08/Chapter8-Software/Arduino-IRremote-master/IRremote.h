@@ -27,54 +27,133 @@
 // Supported IR protocols
 // Each protocol you include costs memory and, during decode, costs time
 // Disable (set to 0) all the protocols you do not need/want!
+// Each can also be set from the build flags, eg. -DDECODE_RC6=0, leaving this
+//   file alone; or, for the decoders of one sketch, see IRrecvProtocols<>
 //
-#define DECODE_RC5           1
-#define SEND_RC5             1
+#ifndef DECODE_RC5
+#	define DECODE_RC5          1
+#endif
+#ifndef SEND_RC5
+#	define SEND_RC5            1
+#endif
 
-#define DECODE_RC6           1
-#define SEND_RC6             1
+#ifndef DECODE_RC6
+#	define DECODE_RC6          1
+#endif
+#ifndef SEND_RC6
+#	define SEND_RC6            1
+#endif
 
-#define DECODE_NEC           1
-#define SEND_NEC             1
+#ifndef DECODE_NEC
+#	define DECODE_NEC          1
+#endif
+#ifndef SEND_NEC
+#	define SEND_NEC            1
+#endif
 
-#define DECODE_SONY          1
-#define SEND_SONY            1
+#ifndef DECODE_SONY
+#	define DECODE_SONY         1
+#endif
+#ifndef SEND_SONY
+#	define SEND_SONY           1
+#endif
 
-#define DECODE_PANASONIC     1
-#define SEND_PANASONIC       1
+#ifndef DECODE_PANASONIC
+#	define DECODE_PANASONIC    1
+#endif
+#ifndef SEND_PANASONIC
+#	define SEND_PANASONIC      1
+#endif
 
-#define DECODE_JVC           1
-#define SEND_JVC             1
+#ifndef DECODE_JVC
+#	define DECODE_JVC          1
+#endif
+#ifndef SEND_JVC
+#	define SEND_JVC            1
+#endif
 
-#define DECODE_SAMSUNG       1
-#define SEND_SAMSUNG         1
+#ifndef DECODE_SAMSUNG
+#	define DECODE_SAMSUNG      1
+#endif
+#ifndef SEND_SAMSUNG
+#	define SEND_SAMSUNG        1
+#endif
 
-#define DECODE_WHYNTER       1
-#define SEND_WHYNTER         1
+#ifndef DECODE_WHYNTER
+#	define DECODE_WHYNTER      1
+#endif
+#ifndef SEND_WHYNTER
+#	define SEND_WHYNTER        1
+#endif
 
-#define DECODE_AIWA_RC_T501  1
-#define SEND_AIWA_RC_T501    1
+#ifndef DECODE_AIWA_RC_T501
+#	define DECODE_AIWA_RC_T501 1
+#endif
+#ifndef SEND_AIWA_RC_T501
+#	define SEND_AIWA_RC_T501   1
+#endif
 
-#define DECODE_LG            1
-#define SEND_LG              0 // NOT WRITTEN
+#ifndef DECODE_LG
+#	define DECODE_LG           1
+#endif
+#ifndef SEND_LG
+#	define SEND_LG             1
+#endif
 
-#define DECODE_SANYO         1
-#define SEND_SANYO           0 // NOT WRITTEN
+#ifndef DECODE_SANYO
+#	define DECODE_SANYO        1
+#endif
+#ifndef SEND_SANYO
+#	define SEND_SANYO          1
+#endif
+
+#ifndef DECODE_MITSUBISHI
+#	define DECODE_MITSUBISHI   1
+#endif
+#ifndef SEND_MITSUBISHI
+#	define SEND_MITSUBISHI     1
+#endif
+
+#ifndef DECODE_DISH
+#	define DECODE_DISH         1
+#endif
+#ifndef SEND_DISH
+#	define SEND_DISH           1
+#endif
 
-#define DECODE_MITSUBISHI    1
-#define SEND_MITSUBISHI      0 // NOT WRITTEN
+#ifndef DECODE_SHARP
+#	define DECODE_SHARP        1
+#endif
+#ifndef SEND_SHARP
+#	define SEND_SHARP          1
+#endif
 
-#define DECODE_DISH          0 // NOT WRITTEN
-#define SEND_DISH            1
+#ifndef DECODE_DENON
+#	define DECODE_DENON        1
+#endif
+#ifndef SEND_DENON
+#	define SEND_DENON          1
+#endif
 
-#define DECODE_SHARP         0 // NOT WRITTEN
-#define SEND_SHARP           1
+#ifndef DECODE_PRONTO
+#	define DECODE_PRONTO       0 // This function doe not logically make sense
+#endif
+#ifndef SEND_PRONTO
+#	define SEND_PRONTO         1
+#endif
 
-#define DECODE_DENON         1
-#define SEND_DENON           1
+#ifndef DECODE_PULSE_DISTANCE
+#	define DECODE_PULSE_DISTANCE 1 // Any pulse-distance code over 32 bits
+#endif
+#ifndef SEND_PULSE_DISTANCE
+#	define SEND_PULSE_DISTANCE 1
+#endif
 
-#define DECODE_PRONTO        0 // This function doe not logically make sense
-#define SEND_PRONTO          1
+// Named protocols decodeFrame() picks from by header windows (not PULSE_DISTANCE)
+#define IR_DECODERS  (DECODE_RC5 + DECODE_RC6 + DECODE_NEC + DECODE_SONY + DECODE_PANASONIC \
+                      + DECODE_JVC + DECODE_SAMSUNG + DECODE_WHYNTER + DECODE_AIWA_RC_T501 \
+                      + DECODE_LG + DECODE_SANYO + DECODE_MITSUBISHI + DECODE_DISH + DECODE_SHARP \
+                      + DECODE_DENON)
 
 //------------------------------------------------------------------------------
 // When sending a Pronto code we request to send either the "once" code
@@ -91,6 +170,12 @@
 #define PRONTO_FALLBACK    true
 #define PRONTO_NOFALLBACK  false
 
+// Longest code (in marks and spaces) sendPronto() takes; it needs as many
+//   bytes of stack.  irProntoParse() takes any length that fits its buffer.
+#ifndef PRONTO_MAX
+#	define PRONTO_MAX  200
+#endif
+
 //------------------------------------------------------------------------------
 // An enumerated list of all supported formats
 // You do NOT need to remove entries from this list when disabling protocols!
@@ -115,6 +200,7 @@ typedef
 		SHARP,
 		DENON,
 		PRONTO,
+		PULSE_DISTANCE,
 	}
 decode_type_t;
 
@@ -136,10 +222,72 @@ decode_type_t;
 
 //------------------------------------------------------------------------------
 // Mark & Space matching functions
+// Without DEBUG they are inline, so that for a constant 'desired' the tick
+//   bounds are worked out by the compiler and each match is two integer compares
 //
+#if DEBUG
 int  MATCH       (int measured, int desired) ;
 int  MATCH_MARK  (int measured_ticks, int desired_us) ;
 int  MATCH_SPACE (int measured_ticks, int desired_us) ;
+#else
+static inline  int  MATCH (int measured,  int desired)
+{
+	return ((measured >= TICKS_LOW(desired)) && (measured <= TICKS_HIGH(desired)));
+}
+
+// Due to sensor lag, when received, Marks tend to be 100us too long
+static inline  int  MATCH_MARK (int measured_ticks,  int desired_us)
+{
+	return ((measured_ticks >= TICKS_LOW (desired_us + MARK_EXCESS))
+	     && (measured_ticks <= TICKS_HIGH(desired_us + MARK_EXCESS)));
+}
+
+// Due to sensor lag, when received, Spaces tend to be 100us too short
+static inline  int  MATCH_SPACE (int measured_ticks,  int desired_us)
+{
+	return ((measured_ticks >= TICKS_LOW (desired_us - MARK_EXCESS))
+	     && (measured_ticks <= TICKS_HIGH(desired_us - MARK_EXCESS)));
+}
+#endif
+
+//------------------------------------------------------------------------------
+// The intervals of a frame, in 50uS ticks, read as  results.rawbuf[i]
+// [0] is the gap before the frame, then alternate marks and spaces.
+// The receiver keeps one byte per interval (see IR_RAW8) and the gap on its
+//   own, while decode(ticks, n, results) reads the caller's unsigned ints;
+//   this reads either as unsigned ints.
+//
+class irraw_t
+{
+	public:
+		unsigned int  operator[] (int i) const
+		{
+			if (!i)    return gap ;
+			if (wide)  return wide[i] ;
+			return frame[i];
+		}
+
+		const volatile irtick_t  *frame;  // A receiver frame : rawframes[slot]
+		const unsigned int       *wide;   // Or a caller's buffer, if not 0
+		unsigned int             gap;
+};
+
+//------------------------------------------------------------------------------
+// Codes over 32 bits are returned in decode_results.data[] : Up to
+//   IR_DATA_BYTES * 8 bits (128 by default; set in IRremoteInt.h, which sizes
+//   the raw buffer to match).  With IR_RAW8 at 0 the raw buffer only holds 48.
+//
+
+// Pulse lengths of a PULSE_DISTANCE code, in uS : What sendPulseDistance() needs
+typedef
+	struct {
+		unsigned int  hdrmark;
+		unsigned int  hdrspace;
+		unsigned int  bitmark;
+		unsigned int  onespace;
+		unsigned int  zerospace;
+	}
+irpulses_t;
 
 //------------------------------------------------------------------------------
 // Results returned from the decoder
@@ -151,16 +299,58 @@ class decode_results
 		unsigned int           address;      // Used by Panasonic & Sharp [16-bits]
 		unsigned long          value;        // Decoded value [max 32-bits]
 		int                    bits;         // Number of bits in decoded value
-		volatile unsigned int  *rawbuf;      // Raw intervals in 50uS ticks
+		uint8_t                data[IR_DATA_BYTES];  // All 'bits' of the code, first bit in the MSB of data[0]
+		irpulses_t             pulses;       // Timing of a PULSE_DISTANCE code
+		irraw_t                rawbuf;       // Raw intervals in 50uS ticks
 		int                    rawlen;       // Number of records in rawbuf
 		int                    overflow;     // true iff IR raw code too long
 };
 
+//------------------------------------------------------------------------------
+// Store bit 'n' of a code in results->data[]; the bits must be stored in order
+//
+static inline  void  irDataBit (decode_results *results,  int n,  uint8_t bit)
+{
+	if (!(n & 7))  results->data[n >> 3] = 0 ;
+	if (bit)       results->data[n >> 3] |= 0x80 >> (n & 7) ;
+}
+
 //------------------------------------------------------------------------------
 // Decoded value for NEC when a repeat code is received
 //
 #define REPEAT 0xFFFFFFFF
 
+//------------------------------------------------------------------------------
+// Called by IRrecv::dispatch() with each decoded code
+// results->rawbuf is only valid until the handler returns
+//
+typedef  void (*irhandler_t)(decode_results *results) ;
+
+#ifndef IR_HANDLERS
+#	define IR_HANDLERS  4  // Protocols which can have an onDecode() handler of their own
+#endif
+
+//------------------------------------------------------------------------------
+// Receiver statistics, from IRrecv::stats() : Counters kept by the ISR and by
+//   decode(), for finding out why presses go missing without DEBUG printing
+//   in the middle of them.  Leave them out with IR_STATS (IRremoteInt.h).
+//
+#define IR_TYPES  (PULSE_DISTANCE + 2)  // decode_type_t values, UNKNOWN to PULSE_DISTANCE
+
+typedef
+	struct {
+		unsigned long  frames;             // Frames recorded by the ISR
+		unsigned int   overflows;          //   cut short at RAWBUF intervals
+		unsigned int   overruns;           // Codes lost while every frame slot was full
+		unsigned int   echoes;             // Our own codes, seen by our own detector and dropped
+		unsigned int   dropped;            // Frames decode() threw away : Too short even to hash
+		unsigned int   tries[IR_TYPES];    // Frames each decoder was run on, by decode_type + 1
+		unsigned int   decoded[IR_TYPES];  //   and took; decoded[0] (UNKNOWN) counts decodeHash() fallbacks
+		unsigned int   isrmax;             // Longest timer ISR in CPU cycles, from the tick (0 : Not timed)
+		unsigned long  decodemax;          // Longest decode() of a frame, in uS
+	}
+irstats_t;
+
 //------------------------------------------------------------------------------
 // Main class for receiving IR
 //
@@ -172,18 +362,74 @@ class IRrecv
 
 		void  blink13    (int blinkflag) ;
 		int   decode     (decode_results *results) ;
+		int   decode     (const unsigned int *ticks,  int n,  decode_results *results) ;
 		void  enableIRIn ( ) ;
+		void  enableIRIn (int capture) ;  // IR_CAPTURE_TIMER or IR_CAPTURE_EDGE
 		bool  isIdle     ( ) ;
 		void  resume     ( ) ;
+		unsigned int  overruns ( ) ;  // Codes lost while all RAWFRAMES slots were full
+		int   markExcess ( ) ;          // Receiver lag in uS, learned with IR_ADAPT_LAG
+		void  markExcess (int us) ;     // Restore a saved lag
+
+		// Instead of decode() and resume() : Register handlers, then call
+		//   dispatch() from loop().  With only per-protocol handlers, the
+		//   decoders of the other protocols are not even tried.
+		void  onDecode   (irhandler_t handler) ;                      // Codes of any protocol
+		bool  onDecode   (decode_type_t type,  irhandler_t handler) ;  // Codes of one protocol; false if IR_HANDLERS are taken
+		int   dispatch   ( ) ;                                         // Handle the codes received; returns how many
+
+		void  stats      (irstats_t *snapshot) ;  // Copy of the counters (all 0 without IR_STATS)
+		void  clearStats ( ) ;
+
+		// The order decode() tries the decoders in, learned with IR_ADAPT_ORDER
+		int   decodeOrder (decode_type_t *types) ;  // Fills types[IR_DECODERS]; returns how many
+#ifdef E2END
+		void  saveOrder   (int address) ;  // Keep it in EEPROM : 1 + IR_DECODERS bytes
+		bool  loadOrder   (int address) ;  // Start from a kept one; false if none was kept
+#endif
+
+	protected:
+		// Runs the decoders over a frame : decodeAll(), or IRrecvProtocols<>'s
+		typedef  bool (*irdecoders_t)(IRrecv *irrecv,  decode_results *results,  irstats_t *counts) ;
+
+		IRrecv (int recvpin,  irdecoders_t decoders) ;
+		IRrecv (int recvpin,  int blinkpin,  irdecoders_t decoders) ;
+
+		void  enableIRIn (int capture,  void (*edgeisr)(void)) ;
 
 	private:
+		template <decode_type_t... TYPES>  friend struct irDecoders;
+
+		// A decoder decodeFrame() can pick, in decoderTable[] (irRecv.cpp)
+		typedef
+			struct {
+				int8_t            type;
+				uint8_t           pinned;  // Keeps its place with IR_ADAPT_ORDER
+				unsigned long     after;   // Bits (type + 1) of decoders it must stay behind
+				const irwindow_t  *windows;
+				bool (IRrecv::*decode)(decode_results *results);
+			}
+		irdecoder_t;
+
+		static const irdecoder_t  decoderTable[];
+		static bool  mayPass    (uint8_t a,  uint8_t b) ;  // May decoderTable[a] move ahead of [b]?
+		void         orderLearn (decode_type_t type) ;
+		void         reorder    ( ) ;
+
+		void  init        (int recvpin,  int blinkpin) ;
+		void  listen      ( ) ;
+		bool  decodeFrame (decode_results *results,  irstats_t *counts) ;
+		bool  tryType     (decode_type_t type,  irstats_t *counts) ;  // Wanted? Then count the try
+		static bool  decodeAll (IRrecv *irrecv,  decode_results *results,  irstats_t *counts) ;
+		template <decode_type_t TYPE>  bool  decodeAs (decode_results *results) ;  // The decoder of TYPE
+		bool  decodeCodec (decode_results *results,  const ircodec_t *codec) ;  // See irCodec.cpp
 		long  decodeHash (decode_results *results) ;
 		int   compare    (unsigned int oldval, unsigned int newval) ;
 
 		//......................................................................
 #		if (DECODE_RC5 || DECODE_RC6)
 			// This helper function is shared by RC5 and RC6
-			int  getRClevel (decode_results *results,  int *offset,  int *used,  int t1) ;
+			int  getRClevel (decode_results *results,  int *offset,  int *used,  const irrange_t *widths) ;
 #		endif
 #		if DECODE_RC5
 			bool  decodeRC5        (decode_results *results) ;
@@ -233,18 +479,265 @@ class IRrecv
 #		endif
 		//......................................................................
 #		if DECODE_DISH
-			bool  decodeDish (decode_results *results) ; // NOT WRITTEN
+			bool  decodeDish       (decode_results *results) ;
 #		endif
 		//......................................................................
 #		if DECODE_SHARP
-			bool  decodeSharp (decode_results *results) ; // NOT WRITTEN
+			bool  decodeSharp      (decode_results *results) ;
 #		endif
 		//......................................................................
 #		if DECODE_DENON
 			bool  decodeDenon (decode_results *results) ;
 #		endif
+		//......................................................................
+#		if DECODE_PULSE_DISTANCE
+			bool  decodePulseDistance (decode_results *results) ;
+#		endif
+
+		volatile irparams_t  *ir;              // This receiver's state : One of irrecvs[]
+		irdecoders_t          decoders;        // What decode() runs over each frame
+#if IR_ADAPT_ORDER
+		uint8_t        order[IR_DECODERS];     // decoderTable[] indexes, in the order tried
+		uint8_t        hits[IR_DECODERS];      // Codes each took lately, by decoderTable[] index
+		uint8_t        nhits;                  // Codes since the last reorder()
+#endif
+
+		irhandler_t    handler;                // onDecode() for any protocol
+		irhandler_t    handlers[IR_HANDLERS];  // onDecode() for one protocol
+		int8_t         types[IR_HANDLERS];     //   which
+		uint8_t        nhandlers;
+		unsigned long  wanted;                 // Bit (decode_type + 1) for each protocol to decode; 0 : All
+#if IR_STATS
+		irstats_t      counts;                 // decode()'s counters; stats() adds the ISR's
+#endif
 } ;
 
+//------------------------------------------------------------------------------
+// The decoder of each protocol, by decode_type_t, for IRrecvProtocols<>
+//
+template <decode_type_t TYPE>
+inline  bool  IRrecv::decodeAs (decode_results *results)
+{
+	static_assert(TYPE != TYPE, "IRrecvProtocols: no decoder for this protocol, or its DECODE_ switch is 0");
+	return false;
+}
+
+#define IR_DECODER(type, decoder) \
+	template <>  inline  bool  IRrecv::decodeAs<type> (decode_results *results)  { return decoder(results); }
+
+IR_DECODER(UNKNOWN, decodeHash)
+#if DECODE_RC5
+	IR_DECODER(RC5, decodeRC5)
+#endif
+#if DECODE_RC6
+	IR_DECODER(RC6, decodeRC6)
+#endif
+#if DECODE_NEC
+	IR_DECODER(NEC, decodeNEC)
+#endif
+#if DECODE_SONY
+	IR_DECODER(SONY, decodeSony)
+#endif
+#if DECODE_PANASONIC
+	IR_DECODER(PANASONIC, decodePanasonic)
+#endif
+#if DECODE_JVC
+	IR_DECODER(JVC, decodeJVC)
+#endif
+#if DECODE_SAMSUNG
+	IR_DECODER(SAMSUNG, decodeSAMSUNG)
+#endif
+#if DECODE_WHYNTER
+	IR_DECODER(WHYNTER, decodeWhynter)
+#endif
+#if DECODE_AIWA_RC_T501
+	IR_DECODER(AIWA_RC_T501, decodeAiwaRCT501)
+#endif
+#if DECODE_LG
+	IR_DECODER(LG, decodeLG)
+#endif
+#if DECODE_SANYO
+	IR_DECODER(SANYO, decodeSanyo)
+#endif
+#if DECODE_MITSUBISHI
+	IR_DECODER(MITSUBISHI, decodeMitsubishi)
+#endif
+#if DECODE_DISH
+	IR_DECODER(DISH, decodeDish)
+#endif
+#if DECODE_SHARP
+	IR_DECODER(SHARP, decodeSharp)
+#endif
+#if DECODE_DENON
+	IR_DECODER(DENON, decodeDenon)
+#endif
+#if DECODE_PULSE_DISTANCE
+	IR_DECODER(PULSE_DISTANCE, decodePulseDistance)
+#endif
+
+//------------------------------------------------------------------------------
+// Try the decoders of TYPES in turn, until one takes the frame
+//
+template <decode_type_t... TYPES>
+struct irDecoders
+{
+	static bool  run (IRrecv *,  decode_results *,  irstats_t *)  { return false; }  // None left
+};
+
+template <decode_type_t TYPE,  decode_type_t... REST>
+struct irDecoders<TYPE, REST...>
+{
+	static bool  run (IRrecv *irrecv,  decode_results *results,  irstats_t *counts)
+	{
+		if (irrecv->tryType(TYPE, counts) && irrecv->decodeAs<TYPE>(results))  return true ;
+		return irDecoders<REST...>::run(irrecv, results, counts);
+	}
+};
+
+//------------------------------------------------------------------------------
+// Receiver which only has the decoders of the protocols listed, tried in the
+//   order listed, eg.
+//     IRrecvProtocols<NEC, SAMSUNG, RC5>  irrecv(11);
+// The DECODE_ switches say which decoders the library is built with; this says
+//   which of them one sketch uses.  Nothing then calls the others, so the
+//   linker drops them from that sketch (Arduino links with --gc-sections),
+//   and other sketches are not affected.  Put the remote you use most first.
+// No header windows are checked, each decoder in turn just rejects the frames
+//   it does not know.  List UNKNOWN last for a decodeHash() value from frames
+//   none of them took; without it decode() drops them.  PULSE_DISTANCE takes
+//   any long code, so list it after the named protocols.
+// With IR_STREAM, codes the ISR decodes on the fly do not come through here.
+//
+template <decode_type_t... TYPES>
+class IRrecvProtocols : public IRrecv
+{
+	public:
+		IRrecvProtocols (int recvpin)                : IRrecv(recvpin, irDecoders<TYPES...>::run)            { }
+		IRrecvProtocols (int recvpin,  int blinkpin) : IRrecv(recvpin, blinkpin, irDecoders<TYPES...>::run)  { }
+} ;
+
+//------------------------------------------------------------------------------
+// Receiver with the detector pin fixed at compile time
+// On boards with a pin map in IRremoteInt.h the port register and bit mask are
+// resolved by the compiler, so sampling the detector is a single IN/LDS.
+//   IR_CAPTURE_EDGE  : the edge handler is specialised for the pin
+//   IR_CAPTURE_TIMER : the library ISR samples the register resolved by
+//                      IRrecv(int); build with IR_SKETCH_ISR=1 and add
+//                      IR_RECV_ISR(pin) to the sketch to specialise it as well
+// IRrecv(int) remains the fallback when the pin is only known at runtime.
+//
+// Either way the ISR no longer calls digitalRead(), so it need not save and
+// restore all twelve call-used registers.  No cycle counts are given here, as
+// none have been measured : On a board, irstats_t.isrmax (IRrecv::stats(),
+// with IR_STATS) after some codes is the longest timer ISR in CPU cycles, and
+// the IRstats example prints it for either kind of receiver.
+//
+template <uint8_t RECVPIN>
+class IRrecvPin : public IRrecv
+{
+	public:
+		IRrecvPin ( )             : IRrecv(RECVPIN)            { }
+		IRrecvPin (int blinkpin)  : IRrecv(RECVPIN, blinkpin)  { }
+
+		void  enableIRIn ( )            { IRrecv::enableIRIn(IR_CAPTURE_TIMER, edgeISR); }
+		void  enableIRIn (int capture)  { IRrecv::enableIRIn(capture, edgeISR); }
+
+		// Sample the detector : MARK or SPACE
+		static inline  uint8_t  level ( )
+		{
+#if defined(IR_PIN_MAP)
+			static_assert(RECVPIN < sizeof(irPinMap), "IRrecvPin: no such pin on this board");
+			return (irPortIn(irPinPort(RECVPIN)) & irPinMask(RECVPIN)) ? SPACE : MARK ;
+#elif defined(CORE_TEENSY)
+			return digitalReadFast(RECVPIN) ? SPACE : MARK ;
+#else
+			return irRecvLevel();
+#endif
+		}
+
+	private:
+		static void  edgeISR ( )  { irEdgeTick(&irparams, level()); }
+} ;
+
+//------------------------------------------------------------------------------
+// Transmit frames compiled into flash
+// A frame is a run of bytes in PROGMEM : The carrier (kHz), the number of
+//   intervals, then the intervals (mark, space, mark, ...) in ticks of
+//   USECPERTICK, as the receiver records them.  An interval of 0 leaves the LED
+//   as it is.  IRsend::sendRaw_P() and sendAsync_P() play them; all the bit
+//   work was done by the compiler, and the frame takes no RAM.
+// The macros build one from a protocol and a value, eg.
+//   const uint8_t  volumeUp[] PROGMEM = { IR_FRAME_NEC(0x20DF40BF) };
+// The timings are those of the protocol's ir_*.cpp; nbits must be a number.
+// IRrawFrame<khz, uS...>::frame builds one from raw timings, as dumped by
+//   IRrecvDumpV2 : One byte per interval rather than an unsigned int.
+// extras/host/irpronto builds one from a Pronto code, and irProntoParse()
+//   does the same at run time, into RAM for sendFrame().
+//
+#define IR_TICKS(usec)  (((usec) >= 255 * USECPERTICK) ? 255 : (((usec) + (USECPERTICK / 2)) / USECPERTICK))
+
+// IR_BITS_n(f, v, ...) : f(bit, ...) for the low n bits of v, first bit the highest
+#define IR_BITS_1(f, v, ...)   f(((v) >> 0) & 1, __VA_ARGS__)
+#define IR_BITS_2(f, v, ...)   f(((v) >> 1) & 1, __VA_ARGS__), IR_BITS_1(f, v, __VA_ARGS__)
+#define IR_BITS_3(f, v, ...)   f(((v) >> 2) & 1, __VA_ARGS__), IR_BITS_2(f, v, __VA_ARGS__)
+#define IR_BITS_4(f, v, ...)   f(((v) >> 3) & 1, __VA_ARGS__), IR_BITS_3(f, v, __VA_ARGS__)
+#define IR_BITS_5(f, v, ...)   f(((v) >> 4) & 1, __VA_ARGS__), IR_BITS_4(f, v, __VA_ARGS__)
+#define IR_BITS_6(f, v, ...)   f(((v) >> 5) & 1, __VA_ARGS__), IR_BITS_5(f, v, __VA_ARGS__)
+#define IR_BITS_7(f, v, ...)   f(((v) >> 6) & 1, __VA_ARGS__), IR_BITS_6(f, v, __VA_ARGS__)
+#define IR_BITS_8(f, v, ...)   f(((v) >> 7) & 1, __VA_ARGS__), IR_BITS_7(f, v, __VA_ARGS__)
+#define IR_BITS_9(f, v, ...)   f(((v) >> 8) & 1, __VA_ARGS__), IR_BITS_8(f, v, __VA_ARGS__)
+#define IR_BITS_10(f, v, ...)  f(((v) >> 9) & 1, __VA_ARGS__), IR_BITS_9(f, v, __VA_ARGS__)
+#define IR_BITS_11(f, v, ...)  f(((v) >> 10) & 1, __VA_ARGS__), IR_BITS_10(f, v, __VA_ARGS__)
+#define IR_BITS_12(f, v, ...)  f(((v) >> 11) & 1, __VA_ARGS__), IR_BITS_11(f, v, __VA_ARGS__)
+#define IR_BITS_13(f, v, ...)  f(((v) >> 12) & 1, __VA_ARGS__), IR_BITS_12(f, v, __VA_ARGS__)
+#define IR_BITS_14(f, v, ...)  f(((v) >> 13) & 1, __VA_ARGS__), IR_BITS_13(f, v, __VA_ARGS__)
+#define IR_BITS_15(f, v, ...)  f(((v) >> 14) & 1, __VA_ARGS__), IR_BITS_14(f, v, __VA_ARGS__)
+#define IR_BITS_16(f, v, ...)  f(((v) >> 15) & 1, __VA_ARGS__), IR_BITS_15(f, v, __VA_ARGS__)
+#define IR_BITS_17(f, v, ...)  f(((v) >> 16) & 1, __VA_ARGS__), IR_BITS_16(f, v, __VA_ARGS__)
+#define IR_BITS_18(f, v, ...)  f(((v) >> 17) & 1, __VA_ARGS__), IR_BITS_17(f, v, __VA_ARGS__)
+#define IR_BITS_19(f, v, ...)  f(((v) >> 18) & 1, __VA_ARGS__), IR_BITS_18(f, v, __VA_ARGS__)
+#define IR_BITS_20(f, v, ...)  f(((v) >> 19) & 1, __VA_ARGS__), IR_BITS_19(f, v, __VA_ARGS__)
+#define IR_BITS_21(f, v, ...)  f(((v) >> 20) & 1, __VA_ARGS__), IR_BITS_20(f, v, __VA_ARGS__)
+#define IR_BITS_22(f, v, ...)  f(((v) >> 21) & 1, __VA_ARGS__), IR_BITS_21(f, v, __VA_ARGS__)
+#define IR_BITS_23(f, v, ...)  f(((v) >> 22) & 1, __VA_ARGS__), IR_BITS_22(f, v, __VA_ARGS__)
+#define IR_BITS_24(f, v, ...)  f(((v) >> 23) & 1, __VA_ARGS__), IR_BITS_23(f, v, __VA_ARGS__)
+#define IR_BITS_25(f, v, ...)  f(((v) >> 24) & 1, __VA_ARGS__), IR_BITS_24(f, v, __VA_ARGS__)
+#define IR_BITS_26(f, v, ...)  f(((v) >> 25) & 1, __VA_ARGS__), IR_BITS_25(f, v, __VA_ARGS__)
+#define IR_BITS_27(f, v, ...)  f(((v) >> 26) & 1, __VA_ARGS__), IR_BITS_26(f, v, __VA_ARGS__)
+#define IR_BITS_28(f, v, ...)  f(((v) >> 27) & 1, __VA_ARGS__), IR_BITS_27(f, v, __VA_ARGS__)
+#define IR_BITS_29(f, v, ...)  f(((v) >> 28) & 1, __VA_ARGS__), IR_BITS_28(f, v, __VA_ARGS__)
+#define IR_BITS_30(f, v, ...)  f(((v) >> 29) & 1, __VA_ARGS__), IR_BITS_29(f, v, __VA_ARGS__)
+#define IR_BITS_31(f, v, ...)  f(((v) >> 30) & 1, __VA_ARGS__), IR_BITS_30(f, v, __VA_ARGS__)
+#define IR_BITS_32(f, v, ...)  f(((v) >> 31) & 1, __VA_ARGS__), IR_BITS_31(f, v, __VA_ARGS__)
+
+// Bit encodings : Pulse distance (bit in the space), pulse width (bit in the
+//   mark) and RC5's bi-phase, which takes four intervals to start on a space
+//   and end on a mark whatever the bit
+#define IR_PD_BIT(b, mark, one, zero)   IR_TICKS(mark),  ((b) ? IR_TICKS(one) : IR_TICKS(zero))
+#define IR_PW_BIT(b, space, one, zero)  ((b) ? IR_TICKS(one) : IR_TICKS(zero)),  IR_TICKS(space)
+#define IR_RC5_BIT(b, t1)               ((b) ? IR_TICKS(t1) : 0),  IR_TICKS(t1),  ((b) ? 0 : IR_TICKS(t1)),  0
+
+#define IR_FRAME_NEC(v) \
+	38,  67,  IR_TICKS(9000), IR_TICKS(4500),  IR_BITS_32(IR_PD_BIT, (v), 560, 1690, 560),  IR_TICKS(560)
+#define IR_FRAME_NEC_REPEAT \
+	38,  3,   IR_TICKS(9000), IR_TICKS(2250),  IR_TICKS(560)
+#define IR_FRAME_SAMSUNG(v) \
+	38,  67,  IR_TICKS(5000), IR_TICKS(5000),  IR_BITS_32(IR_PD_BIT, (v), 560, 1600, 560),  IR_TICKS(560)
+#define IR_FRAME_SONY(v, nbits) \
+	40,  2 + (2 * nbits),  IR_TICKS(2400), IR_TICKS(600),  IR_BITS_##nbits(IR_PW_BIT, (v), 600, 1200, 600)
+#define IR_FRAME_RC5(v, nbits) \
+	36,  3 + (4 * nbits),  IR_TICKS(889), IR_TICKS(889), IR_TICKS(889),  IR_BITS_##nbits(IR_RC5_BIT, (v), 889)
+
+template <uint8_t KHZ, unsigned int... USECS>
+struct IRrawFrame
+{
+	static_assert(sizeof...(USECS) < 256, "IRrawFrame: too many intervals");
+	static const uint8_t  frame[2 + sizeof...(USECS)];
+} ;
+
+template <uint8_t KHZ, unsigned int... USECS>
+const uint8_t  IRrawFrame<KHZ, USECS...>::frame[2 + sizeof...(USECS)] PROGMEM = { KHZ, sizeof...(USECS), IR_TICKS(USECS)... };
+
 //------------------------------------------------------------------------------
 // Main class for sending IR
 //
@@ -258,6 +751,24 @@ class IRsend
 		void  mark        		(unsigned int usec) ;
 		void  space       		(unsigned int usec) ;
 		void  sendRaw     		(unsigned int buf[],  unsigned int len,  unsigned int hz) ;
+		void  sendRaw_P   		(const unsigned int buf[],  unsigned int len,  unsigned int khz) ;  // buf[] in PROGMEM
+		void  sendRaw_P   		(const uint8_t *frame) ;                                          // IR_FRAME_... / IRrawFrame
+		void  sendFrame   		(const uint8_t *frame) ;                                          // As above, in RAM
+
+#		if IR_SEND_QUEUE
+			// Non-blocking : The timer ISR plays buf[] while the sketch carries on
+			bool  sendAsync      (const unsigned int buf[],  unsigned int len,  unsigned int khz,
+			                      uint8_t repeats = 0,  uint8_t gap = 0) ;
+			bool  sendAsync_P    (const unsigned int buf[],  unsigned int len,  unsigned int khz,
+			                      uint8_t repeats = 0,  uint8_t gap = 0) ;
+			bool  sendAsync      (const uint8_t *frame,  uint8_t repeats = 0,  uint8_t gap = 0) ;
+			bool  sendAsync_P    (const uint8_t *frame,  uint8_t repeats = 0,  uint8_t gap = 0) ;
+			bool  sending        ( ) ;
+#		endif
+
+		// Any protocol described by an ircodec_t (see irCodec.cpp)
+		void  sendCodec   		(const ircodec_t *codec,  unsigned long data,  int nbits,  bool repeat = false) ;
+		void  sendCodec   		(const ircodec_t *codec,  const uint8_t *data,  int nbits,  bool repeat = false) ;
 
 		//......................................................................
 #		if SEND_RC5
@@ -300,15 +811,15 @@ class IRsend
 #		endif
 		//......................................................................
 #		if SEND_LG
-			void  sendLG         ( ) ; // NOT WRITTEN
+			void  sendLG         (unsigned long data,  int nbits) ;
 #		endif
 		//......................................................................
 #		if SEND_SANYO
-			void  sendSanyo      ( ) ; // NOT WRITTEN
+			void  sendSanyo      (unsigned long data,  int nbits) ;
 #		endif
 		//......................................................................
-#		if SEND_MISUBISHI
-			void  sendMitsubishi ( ) ; // NOT WRITTEN
+#		if SEND_MITSUBISHI
+			void  sendMitsubishi (unsigned long data,  int nbits) ;
 #		endif
 		//......................................................................
 #		if SEND_DISH
@@ -324,9 +835,191 @@ class IRsend
 			void  sendDenon      (unsigned long data,  int nbits) ;
 #		endif
 		//......................................................................
-#		if SEND_Pronto
-			void  sendPronto     (char* code,  bool repeat,  bool fallback) ;
+#		if SEND_PRONTO
+			bool  sendPronto     (const char *code,  bool repeat,  bool fallback) ;
 #		endif
+		//......................................................................
+#		if SEND_PULSE_DISTANCE
+			void  sendPulseDistance (const irpulses_t *pulses,  const uint8_t *data,  int nbits,  int khz) ;
+#		endif
+
+	private:
+		void  sendTicks (const uint8_t *frame,  bool progmem) ;
+#	if IR_SEND_QUEUE
+		bool  queue (const void *buf,  unsigned int len,  uint8_t kind,  unsigned int khz,  uint8_t repeats,  uint8_t gap) ;
+#	endif
+} ;
+
+#if IR_BLAST_CHANNELS
+//------------------------------------------------------------------------------
+// IR blaster : An emitter on each 16 bit timer the library is not using, all
+//   sending at once (see irBlaster.cpp)
+//   Arduino Mega : Channels 0..3 on pins 11, 5, 6 and 46 (timers 1, 3, 4, 5)
+//   Uno-class    : Channel 0 on pin 9 (timer 1)
+// Those timers then no longer serve analogWrite() on their pins, nor Servo.
+// Frames are queued and played by the timer ISR, as for IRsend::sendAsync();
+//   IRsend waits for the blaster to finish; send() and send_P() return false
+//   while IRsend::sendAsync() frames are going out.
+// Left out unless IR_BLASTER is set in IRremoteInt.h.
+//
+class IRblaster
+{
+	public:
+		static uint8_t  channels ( )  { return IR_BLAST_CHANNELS; }
+		static uint8_t  pin      (uint8_t channel) ;
+
+		bool  send    (uint8_t channel,  const uint8_t *frame,  uint8_t repeats = 0,  uint8_t gap = 0) ;  // In RAM
+		bool  send_P  (uint8_t channel,  const uint8_t *frame,  uint8_t repeats = 0,  uint8_t gap = 0) ;  // In PROGMEM
+		bool  sending ( ) ;
+		bool  sending (uint8_t channel) ;
+
+	private:
+		bool  queue (uint8_t channel,  const uint8_t *frame,  bool progmem,  uint8_t repeats,  uint8_t gap) ;
+} ;
+#endif
+
+#if SEND_PRONTO
+// Parse a Pronto code into a frame for sendFrame() or sendAsync() (see irPronto.cpp)
+int  irProntoParse (const char *pronto,  uint8_t *frame,  int size,  bool repeat,  bool fallback,
+                    uint8_t *gap = 0) ;
+#endif
+
+//------------------------------------------------------------------------------
+// Learned-code tables : Map decoded codes to the sketch's own action numbers
+// Entries are kept sorted by value, then decode_type, then address, so lookup()
+//   is a binary search : 8 reads for 256 buttons, instead of a chain of
+//   if/else compares.
+// Only PANASONIC codes carry an address (the same 32 bits of data mean
+//   different buttons on different devices); it is 0 for the others.
+//
+typedef
+	struct {
+		unsigned long  value;        // results.value : The code, or the hash for UNKNOWN
+		unsigned int   address;      // results.address for PANASONIC, otherwise 0
+		int8_t         decode_type;  // results.decode_type
+		uint8_t        action;       // What lookup() returns for it
+	}
+ircode_t;
+
+#define IR_CODE(type, value, action)                   { (value), 0, (type), (action) }
+#define IR_CODE_ADDRESS(type, address, value, action)  { (value), (address), (type), (action) }
+#define IR_NO_ACTION  -1
+
+class IRcodes
+{
+	public:
+		int           lookup (decode_results *results) ;  // The action, or IR_NO_ACTION
+		bool          sorted ( ) ;                        // false if the table is out of order
+		unsigned int  count  ( )  { return entries; }
+
+	protected:
+		IRcodes (unsigned int n) : entries(n) { }
+		virtual void  read (unsigned int i,  ircode_t *code) = 0 ;
+		unsigned int  find (const ircode_t *key,  bool *found) ;
+
+		unsigned int  entries;
+} ;
+
+// A table in flash, eg.
+//   const ircode_t  buttons[] PROGMEM = { IR_CODE(NEC, 0x20DF10EF, 1), ... };
+//   IRcodesPROGMEM  actions(buttons, sizeof(buttons) / sizeof(buttons[0]));
+// The entries must be in order of value (sorted() checks)
+class IRcodesPROGMEM : public IRcodes
+{
+	public:
+		IRcodesPROGMEM (const ircode_t *table,  unsigned int n) : IRcodes(n), table(table) { }
+
+	private:
+		void  read (unsigned int i,  ircode_t *code) ;
+
+		const ircode_t  *table;
+} ;
+
+#ifdef E2END
+// A table learned at run time and kept in EEPROM : A count, then up to
+//   'capacity' entries, from EEPROM address 'base'
+class IRcodesEEPROM : public IRcodes
+{
+	public:
+		IRcodesEEPROM (int base,  unsigned int capacity) ;
+
+		bool  learn  (decode_results *results,  uint8_t action) ;  // false if full
+		bool  forget (decode_results *results) ;                   // false if not there
+		void  clear  ( ) ;
+
+	private:
+		void  read  (unsigned int i,  ircode_t *code) ;
+		void  write (unsigned int i,  const ircode_t *code) ;
+
+		int           base;
+		unsigned int  capacity;
+} ;
+#endif
+
+//------------------------------------------------------------------------------
+// Key events : One IR_KEY_DOWN when a button is pressed, IR_KEY_REPEAT at a
+//   steady rate while it is held, and one IR_KEY_UP when it is let go
+// However the remote says "still held" (NEC repeat frames, RC5/RC6 sending the
+//   same toggle bit, Sony's frames in threes, Samsung resending the code), the
+//   sketch sees the same events, so it needs no delay() to skip repeats :
+//     IRkeys  keys(&irrecv);
+//     irkey_t key;
+//     if (keys.event(&key) && (key.event == IR_KEY_DOWN))  ...
+//
+#ifndef IR_KEY_RELEASE
+#	define IR_KEY_RELEASE  160  // mS without a frame before the key is up (> the remote's repeat period)
+#endif
+#ifndef IR_KEY_DELAY
+#	define IR_KEY_DELAY    500  // mS from IR_KEY_DOWN to the first IR_KEY_REPEAT
+#endif
+#ifndef IR_KEY_RATE
+#	define IR_KEY_RATE     100  // mS between IR_KEY_REPEATs
+#endif
+
+#define IR_KEY_DOWN    1
+#define IR_KEY_REPEAT  2
+#define IR_KEY_UP      3
+
+typedef
+	struct {
+		uint8_t        event;        // IR_KEY_DOWN, IR_KEY_REPEAT or IR_KEY_UP
+		decode_type_t  decode_type;  // The key : Its protocol
+		unsigned long  value;        //   and code, without the RC5/RC6 toggle bit
+		int            bits;         //   and length
+		unsigned long  time;         // millis() of the event
+		unsigned long  held;         // mS since the IR_KEY_DOWN
+		unsigned int   repeats;      // IR_KEY_REPEATs so far in this press
+	}
+irkey_t;
+
+class IRkeys
+{
+	public:
+		IRkeys (IRrecv *irrecv) ;
+
+		bool          event  (irkey_t *key) ;                // Call from loop(); true if *key is a new event
+		bool          held   ( )  { return down; }           // A key is down
+		unsigned int  frames ( )  { return nframes; }        // Frames received in this (or the last) press
+		unsigned int  period ( )  { return framems; }        // Average mS between the remote's frames of a held key; 0 until seen
+
+	private:
+		bool  sameKey (unsigned long toggle) ;
+		bool  report  (irkey_t *key,  uint8_t event,  unsigned long now) ;
+
+		IRrecv          *irrecv;
+		decode_results  results;    // The last frame
+		bool            down;       // A key is held
+		bool            pending;    // results holds a new key, to go down once the held one is up
+		decode_type_t   type;       // The held key
+		unsigned long   value;
+		int             bits;
+		unsigned long   toggle;     // Its RC5/RC6 toggle bit
+		unsigned long   downms;     // millis() of its IR_KEY_DOWN
+		unsigned long   lastms;     //   of its last frame
+		unsigned long   nextms;     //   when the next IR_KEY_REPEAT is due
+		unsigned int    repeats;
+		unsigned int    nframes;
+		unsigned int    framems;
 } ;
 
 #endif
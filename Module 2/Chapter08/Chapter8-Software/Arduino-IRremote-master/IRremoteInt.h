@@ -40,7 +40,129 @@
 //------------------------------------------------------------------------------
 // Information for the Interrupt Service Routine
 //
-#define RAWBUF  101  // Maximum length of raw duration buffer
+// Intervals are stored one byte each (IR_RAW8), so twice as many fit in the
+//   RAM that two-byte entries took.  A mark or space over 254 ticks (12.7mS)
+//   is stored as IR_TICK_MAX; the gap before a frame, the only interval that
+//   is usually that long, is kept in full alongside it in framegap[].
+// Set IR_RAW8 to 0 to store every interval in an unsigned int.
+#ifndef IR_RAW8
+#	define IR_RAW8  1
+#endif
+
+// Longest code decode_results.data[] holds, in bytes (see IRremote.h)
+#ifndef IR_DATA_BYTES
+#	define IR_DATA_BYTES  16
+#endif
+
+// With IR_RAW8 the raw buffer holds a frame of IR_DATA_BYTES * 8 bits : The
+//   gap, header mark and space, a mark and space per bit and the last mark,
+//   plus one, as a frame which fills the buffer is taken to have overflowed.
+//   With two-byte entries it stays at 101, which is 48 bits.
+#if IR_RAW8
+	typedef  uint8_t       irtick_t;
+#	define IR_TICK_MAX  0xFF
+#	define RAWBUF       (2 * 8 * IR_DATA_BYTES + 5)  // Maximum length of raw duration buffer
+#else
+	typedef  unsigned int  irtick_t;
+#	define IR_TICK_MAX  0xFFFF
+#	define RAWBUF       101  // Maximum length of raw duration buffer
+#endif
+
+// Count of entries in a raw buffer : One byte, unless RAWBUF needs two
+#if RAWBUF > 0xFF
+	typedef  uint16_t      irlen_t;
+#	define IR_READ_LEN(p)  pgm_read_word(p)
+#else
+	typedef  uint8_t       irlen_t;
+#	define IR_READ_LEN(p)  pgm_read_byte(p)
+#endif
+
+// Number of complete frames the receiver can hold while the sketch is decoding
+// With more than one, capture carries on into a free slot as soon as a frame
+//   ends, so a burst of codes (eg. NEC + repeats) is not lost during decode().
+// Each extra frame costs RAWBUF * sizeof(irtick_t) bytes of RAM.
+#ifndef RAWFRAMES
+#	define RAWFRAMES  1
+#endif
+
+// Set IR_STREAM to 1 to decode NEC and Samsung codes in the ISR, bit by bit,
+//   as they arrive.  decode() then has the result as soon as the last bit ends,
+//   rather than after the 5mS gap and a walk of the whole buffer.
+#ifndef IR_STREAM
+#	define IR_STREAM  0
+#endif
+
+// A frame normally ends after _GAP (5mS) of silence.  With IR_EARLY_END the ISR
+//   looks up the header of each frame among the protocols whose frames have a
+//   fixed length (see irend_t), and ends a frame of that length as soon as the
+//   space after its last mark is longer than any of their bit spaces : After
+//   about 2mS rather than 5mS for NEC.  Other frames still wait for _GAP.
+#ifndef IR_EARLY_END
+#	define IR_EARLY_END  1
+#endif
+
+// Receivers differ in how much longer than sent their marks come out.  With
+//   IR_ADAPT_LAG the receiver learns its own lag from the codes it decodes and
+//   evens out any difference from MARK_EXCESS before decoding (see
+//   IRrecv::markExcess()).  Set it to 0 to always assume MARK_EXCESS.
+#ifndef IR_ADAPT_LAG
+#	define IR_ADAPT_LAG  1
+#endif
+
+// decode() tries the decoders whose header windows fit a frame one after the
+//   other.  With IR_ADAPT_ORDER each receiver counts which of them take its
+//   frames and, every IR_ORDER_EVERY codes, moves those forward; a decoder
+//   never passes one which could take the same frame (see irRecv.cpp), so
+//   what a frame decodes to does not change.  See also IRrecv::saveOrder().
+#ifndef IR_ADAPT_ORDER
+#	define IR_ADAPT_ORDER  1
+#endif
+#ifndef IR_ORDER_EVERY
+#	define IR_ORDER_EVERY  16
+#endif
+
+// Receivers (IRrecv objects on different pins) which can be active at once.
+//   Each has its own state machine and frame buffers, so each costs the
+//   RAM of an irparams_t.  The timer ISR reads every port they use once per
+//   tick and runs each receiver's state machine on its own bit.
+//   Only the first receiver can use IR_CAPTURE_EDGE or IR_SKETCH_ISR;
+//   the others are always sampled by the library's timer ISR.
+#ifndef IR_RECEIVERS
+#	define IR_RECEIVERS  1
+#endif
+
+// Statistics (see IRrecv::stats()) : Each counter costs an increment where it
+//   is counted, and the timer ISR reads the timer once to time itself.
+//   Set IR_STATS to 0 to leave them out, and the RAM they take.
+#ifndef IR_STATS
+#	define IR_STATS  1
+#endif
+
+// Frames IRsend::sendAsync() can hold, the one going out included.  Each slot
+//   costs a few bytes of RAM; the timings stay in the sketch's own array.
+//   Set IR_SEND_QUEUE to 0 to leave asynchronous sending out.
+#ifndef IR_SEND_QUEUE
+#	define IR_SEND_QUEUE  4
+#endif
+
+// Full duplex : IRsend takes the timer from the receivers for the carrier, and
+//   gives it back once the code has gone out (see irRecvResume), so they go on
+//   receiving without enableIRIn() being called again.
+// A frame which starts while our LED is on, or within IR_ECHO_GUARD uS of it
+//   going off, is our own code seen by our own detector : It is dropped, and
+//   counted in irstats_t.echoes.  Set IR_ECHO_GUARD to 0 to keep them.
+#ifndef IR_ECHO_GUARD
+#	define IR_ECHO_GUARD  1000
+#endif
+
+// Frames IRblaster can hold waiting for their emitter, on top of the one each
+//   emitter is sending.  The emitters are the spare 16 bit timers (see
+//   IR_BLAST_CHANNELS), so only the Mega and Uno-class boards have any.
+//   The blaster adds to the timer ISR and takes RAM, so it is left out unless
+//   IR_BLASTER is set, eg. to 8.
+#ifndef IR_BLASTER
+#	define IR_BLASTER  0
+#endif
 
 typedef
 	struct {
@@ -49,13 +171,59 @@ typedef
 		uint8_t       recvpin;         // Pin connected to IR data from detector
 		uint8_t       blinkpin;
 		uint8_t       blinkflag;       // true -> enable blinking of pin on IR processing
-		uint8_t       rawlen;          // counter of entries in rawbuf
+		irlen_t       rawlen;          // counter of entries in rawbuf
+		uint8_t       capture;         // IR_CAPTURE_TIMER or IR_CAPTURE_EDGE
+		uint8_t       recvmask;        // Bit of recvpin within its port
+		uint8_t       recvport;        // Index of recvreg in irPorts[] (IR_RECEIVERS > 1)
+		uint8_t       blinkmask;       // Bit of blinkpin within its port
+		volatile uint8_t  *recvreg;    // Input register of recvpin's port
+		volatile uint8_t  *blinkreg;   // Output register of blinkpin's port (0 -> BLINKLED)
 		unsigned int  timer;           // State timer, counts 50uS ticks.
-		unsigned int  rawbuf[RAWBUF];  // raw data
+		unsigned long lastedge;        // micros() of the last detector edge (edge capture only)
+		volatile irtick_t  *rawbuf;    // Frame being recorded : rawframes[framehead]
 		uint8_t       overflow;        // Raw buffer overflow occurred
+		uint8_t       framehead;       // Slot being recorded
+		uint8_t       frametail;       // Oldest complete slot (next for decode)
+		uint8_t       frames;          // Number of complete slots waiting
+		unsigned int  overruns;        // Frames lost because every slot was full
+#if IR_STATS
+		unsigned long framecount;      // Frames recorded
+		unsigned int  ovfcount;        // Frames cut short by overflow
+#	if IR_ECHO_GUARD
+		unsigned int  echocount;       // Frames dropped as echoes of our own sending
+#	endif
+#endif
+#if IR_ECHO_GUARD
+		uint8_t       echo;            // Frame being recorded began while we were sending
+#endif
+		irlen_t       framelen[RAWFRAMES];  // rawlen of each complete slot
+		uint8_t       frameovf[RAWFRAMES];  // overflow of each complete slot
+		uint8_t       frameseen[RAWFRAMES]; // decode() has had the slot : Its lag is applied, and it is counted
+		unsigned int  framegap[RAWFRAMES];  // Gap before each slot's frame (ticks)
+		irtick_t      rawframes[RAWFRAMES][RAWBUF];  // raw data
+#if IR_ADAPT_LAG
+		int           lagdelta;        // Learned detector lag minus MARK_EXCESS (uS)
+#endif
+#if IR_EARLY_END
+		irlen_t       endlen;          // rawlen of the frame being recorded, from its header; 0 -> unknown
+		uint8_t       endquiet;        // Space after its last mark which ends it (ticks)
+#endif
+#if IR_STREAM
+		uint8_t       stream;          // Protocol being followed : irStreams[stream-1], 0 -> none
+		uint8_t       streamready;     // IR_STREAM_READY or IR_STREAM_TAKEN
+		uint8_t       streamout;       // decode() last returned a streamed code
+		int8_t        streamtype;      // decode_type of the streamed code
+		uint8_t       streambits;      // bits of the streamed code
+		irlen_t       streamlen;       // rawlen when the streamed code completed
+		unsigned long streamvalue;     // Bits so far; the value once ready
+#endif
 	}
 irparams_t;
 
+// Streaming decode : State of the code in irparams.streamvalue
+#define IR_STREAM_READY  1  // Complete, waiting for decode()
+#define IR_STREAM_TAKEN  2  // Returned by decode(); drop the frame when it ends
+
 // ISR State-Machine : Receiver States
 #define STATE_IDLE      2
 #define STATE_MARK      3
@@ -63,10 +231,68 @@ irparams_t;
 #define STATE_STOP      5
 #define STATE_OVERFLOW  6
 
+// Capture engines : Selected by IRrecv::enableIRIn()
+#define IR_CAPTURE_TIMER  0  // Sample the detector every USECPERTICK uS (default)
+#define IR_CAPTURE_EDGE   1  // Timestamp each detector edge (pin must support attachInterrupt)
+
 // Allow all parts of the code access to the ISR data
 // NB. The data can be changed by the ISR at any time, even mid-function
 // Therefore we declare it as "volatile" to stop the compiler/CPU caching it
-EXTERN  volatile irparams_t  irparams;
+// irparams is the first receiver, and the only one unless IR_RECEIVERS > 1
+// A receiver whose rcvstate is 0 has not been enabled
+EXTERN  volatile irparams_t  irrecvs[IR_RECEIVERS];
+#define irparams  (irrecvs[0])
+
+#if IR_STATS
+// Longest run of the timer ISR, in CPU cycles (see IR_ISR_TIMED())
+EXTERN  volatile unsigned int  irIsrMax;
+#endif
+
+#if IR_RECEIVERS > 1
+// The input registers of the receivers' ports, each listed once
+EXTERN  volatile uint8_t * volatile  irPorts[IR_RECEIVERS];
+EXTERN  volatile uint8_t             irNumPorts;
+#endif
+
+//------------------------------------------------------------------------------
+// Full duplex : What IRsend is doing to the receivers
+// irtxtimer is set by IRsend::enableIROut() when it took the timer from
+//   receivers sampled by it; irRecvResume() gives it back.
+// irtxled and irtxoff tell a frame's first mark from an echo of ours.
+//
+EXTERN  volatile uint8_t        irtxtimer;   // The receivers are waiting for the timer
+EXTERN  volatile uint8_t        irtxled;     // Our LED is on
+EXTERN  volatile unsigned long  irtxoff;     // micros() when it last went off
+
+#if IR_SEND_QUEUE
+//------------------------------------------------------------------------------
+// Asynchronous send : A frame queued by IRsend::sendAsync() or sendAsync_P()
+//
+#define IR_SENDQ_RAM    0  // buf[] is unsigned int uS in RAM
+#define IR_SENDQ_P      1  // buf[] is unsigned int uS in PROGMEM
+#define IR_SENDQ_TICKS  2  // buf[] is uint8_t ticks in PROGMEM (IR_FRAME_... / IRrawFrame)
+#define IR_SENDQ_RAM8   3  // buf[] is uint8_t ticks in RAM (irProntoParse)
+
+typedef
+	struct {
+		const void    *buf;      // Mark, space, mark, ... as 'kind' says
+		unsigned int   len;      // Entries in buf[]
+		uint8_t        kind;     // IR_SENDQ_...
+		uint8_t        khz;      // Carrier
+		uint8_t        repeats;  // Copies still to send after this one
+		uint8_t        gap;      // Silence after each copy (mS)
+	}
+irsendq_t;
+
+// The queue, played by irSendStep() from the timer ISR
+// The frame going out is irsendq[irsendhead]; irsendi is its next entry, which
+//   starts when micros() reaches irsendend
+EXTERN  volatile irsendq_t      irsendq[IR_SEND_QUEUE];
+EXTERN  volatile uint8_t        irsendhead;
+EXTERN  volatile uint8_t        irsendcount;
+EXTERN  volatile unsigned int   irsendi;
+EXTERN  volatile unsigned long  irsendend;
+#endif
 
 //------------------------------------------------------------------------------
 // Defines for blinking the LED
@@ -121,6 +347,7 @@ EXTERN  volatile irparams_t  irparams;
 
 // Due to sensor lag, when received, Marks  tend to be 100us too long and
 //                                   Spaces tend to be 100us too short
+// With IR_ADAPT_LAG this is only where each receiver starts from
 #define MARK_EXCESS    100
 
 // microseconds per clock interrupt tick
@@ -135,8 +362,138 @@ EXTERN  volatile irparams_t  irparams;
 #define _GAP            5000
 #define GAP_TICKS       (_GAP/USECPERTICK)
 
-#define TICKS_LOW(us)   ((int)(((us)*LTOL/USECPERTICK)))
-#define TICKS_HIGH(us)  ((int)(((us)*UTOL/USECPERTICK + 1)))
+// Most bits any named protocol sends (Panasonic); longer frames are tried as
+//   PULSE_DISTANCE before the named decoders, which would take just their start
+#define IR_NAMED_MAX_BITS  48
+
+// Tick bounds of a pulse, in integer arithmetic (same results as LTOL/UTOL)
+// With a constant argument they fold to a constant, so no floating point
+//   is used when matching
+#define TICKS_LOW(us)   ((int)(((long)(us) * (100 - TOLERANCE)) / (100L * USECPERTICK)))
+#define TICKS_HIGH(us)  ((int)(((long)(us) * (100 + TOLERANCE)) / (100L * USECPERTICK) + 1))
+
+// Accepted tick range of an interval, for decoders which look their bounds up
+typedef
+	struct {
+		unsigned int  lo;  // Shortest accepted value (ticks)
+		unsigned int  hi;  // Longest accepted value (ticks)
+	}
+irrange_t;
+
+#define IR_MARK_RANGE(us)   { TICKS_LOW((us) + MARK_EXCESS), TICKS_HIGH((us) + MARK_EXCESS) }
+#define IR_SPACE_RANGE(us)  { TICKS_LOW((us) - MARK_EXCESS), TICKS_HIGH((us) - MARK_EXCESS) }
+
+//------------------------------------------------------------------------------
+// Streaming decode (IR_STREAM) : Timing of a pulse-distance protocol
+// A header, then 'bits' data bits MSB first, each a fixed mark followed by a
+//   long (1) or short (0) space.  A header mark then 'rptspace' and one bit
+//   mark is a repeat.  Each protocol defines one alongside its decoder.
+//
+typedef
+	struct {
+		int8_t        type;       // decode_type reported
+		uint8_t       bits;       // Data bits in a full code
+		unsigned int  mingap;     // Shortest gap before a full code (ticks)
+		irrange_t     hdrmark;
+		irrange_t     hdrspace;
+		irrange_t     rptspace;
+		irrange_t     bitmark;
+		irrange_t     onespace;
+		irrange_t     zerospace;
+	}
+irstream_t;
+
+//------------------------------------------------------------------------------
+// Early end of frame (IR_EARLY_END) : A header, and the length of the frames
+//   it starts.  Each protocol whose frames have a fixed length defines these
+//   in PROGMEM alongside its decoder; irEnds[] in irISR.cpp lists them.
+// Where headers of several protocols look alike, the longest frame is waited
+//   for.  A longer code which merely shares the header (eg. a 48 bit A/C
+//   code) is not cut short, as its next mark comes within 'quiet'.
+//
+typedef
+	struct {
+		uint8_t  marklo,   markhi;    // Header mark (ticks)
+		uint8_t  spacelo,  spacehi;   // Header space (ticks)
+		irlen_t  len;                 // rawlen of the whole frame : Gap to last mark
+		uint8_t  quiet;               // Space after the last mark which ends it (ticks)
+	}
+irend_t;
+
+#define IR_END(hdrmark, hdrspace, len, bitspace) \
+	{ TICKS_LOW ((hdrmark)  + MARK_EXCESS),  TICKS_HIGH((hdrmark)  + MARK_EXCESS), \
+	  TICKS_LOW ((hdrspace) - MARK_EXCESS),  TICKS_HIGH((hdrspace) - MARK_EXCESS), \
+	  (len),  TICKS_HIGH((bitspace) - MARK_EXCESS) }
+
+extern const irend_t * const  irEnds[];  // Ends with 0
+
+//------------------------------------------------------------------------------
+// Header windows : Let IRrecv::decode() skip decoders which cannot match
+// Each decoder lists the rawbuf[] values its first test can accept (in ticks),
+//   ending with IR_WINDOW_END.  The gap and header mark are classified once per
+//   frame and only decoders with a matching window are tried.
+//
+typedef
+	struct {
+		uint8_t       index;  // rawbuf[] entry tested : 0 -> gap, 1 -> header mark
+		unsigned int  lo;     // Shortest accepted value (ticks)
+		unsigned int  hi;     // Longest accepted value (ticks)
+	}
+irwindow_t;
+
+#define IR_MARK_WINDOW(us)   { 1, TICKS_LOW((us) + MARK_EXCESS), TICKS_HIGH((us) + MARK_EXCESS) }
+#define IR_GAP_BELOW(ticks)  { 0, 0, (ticks) - 1 }
+#define IR_WINDOW_END        { 0xFF, 0, 0 }
+
+//------------------------------------------------------------------------------
+// Lag learning (IR_ADAPT_LAG) : An interval of fixed length found in every bit
+//   of a protocol, whatever the bit's value, eg. the bit mark of NEC.  After a
+//   code of that protocol decodes, their average length shows the detector lag.
+//
+typedef
+	struct {
+		uint8_t       first;  // rawbuf[] index of the first one; then every other entry
+		unsigned int  us;     // Length as sent : a mark if 'first' is odd, else a space
+	}
+irlag_t;
+
+//------------------------------------------------------------------------------
+// Codec descriptors : A protocol which sends each bit as a mark and a space,
+//   as data for the one send and decode loop in irCodec.cpp.  Each length is
+//   kept as sent (uS) and as the tick range decoding accepts, both worked
+//   out by the compiler, so decoding does no arithmetic on them.
+// Descriptors live in flash (PROGMEM).
+//
+typedef
+	struct {
+		unsigned int  mark;    // As sent (uS); 0 -> not sent
+		unsigned int  space;
+		irrange_t     marks;   // Accepted when received (ticks)
+		irrange_t     spaces;
+	}
+irpair_t;
+
+#define IR_PAIR(mark, space)  { (mark), (space), IR_MARK_RANGE(mark), IR_SPACE_RANGE(space) }
+#define IR_MARK_ONLY(mark)    { (mark), 0, IR_MARK_RANGE(mark), { 0, 0 } }  // No space, eg. a footer
+#define IR_NO_PAIR            { 0, 0, { 0, 0 }, { 0, 0 } }
+
+typedef
+	struct {
+		int8_t    type;   // decode_type reported
+		uint8_t   bits;   // Bits in a code, first bit first
+		uint8_t   khz;    // Carrier
+		uint8_t   flags;  // IR_CODEC_*
+		irpair_t  lead;   // Sent before the header (mark 0 -> none)
+		irpair_t  hdr;    // Header (mark 0 -> none)
+		irpair_t  one;    // A 1 bit
+		irpair_t  zero;   // A 0 bit
+		irpair_t  stop;   // Footer mark, then the space to end on (mark 0 -> none)
+		irpair_t  rpt;    // Repeat : This pair, then the stop mark (mark 0 -> none)
+	}
+ircodec_t;
+
+#define IR_CODEC_RPT_BARE  0x01  // A repeat is the code without its header (JVC)
+#define IR_CODEC_EXACT     0x02  // Decode only frames of exactly the code's length
 
 //------------------------------------------------------------------------------
 // IR detector output is active low
@@ -144,6 +501,430 @@ EXTERN  volatile irparams_t  irparams;
 #define MARK   0
 #define SPACE  1
 
+//------------------------------------------------------------------------------
+// Compile-time pin maps, used by IRrecvPin<pin> to sample the detector with a
+// single register read. Each entry is (port << 3) | bit for one Arduino pin.
+// Boards without a map here fall back to the register resolved at runtime.
+//
+enum { IR_PORT_A, IR_PORT_B, IR_PORT_C, IR_PORT_D, IR_PORT_E, IR_PORT_F,
+       IR_PORT_G, IR_PORT_H, IR_PORT_J, IR_PORT_K, IR_PORT_L };
+#define IR_P(port, bit)  ((IR_PORT_##port << 3) | (bit))
+
+// Arduino Mega
+#if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+#	define IR_PIN_MAP
+	static constexpr uint8_t  irPinMap[] = {
+		IR_P(E,0), IR_P(E,1), IR_P(E,4), IR_P(E,5), IR_P(G,5), IR_P(E,3), IR_P(H,3), IR_P(H,4),  //  0.. 7
+		IR_P(H,5), IR_P(H,6), IR_P(B,4), IR_P(B,5), IR_P(B,6), IR_P(B,7), IR_P(J,1), IR_P(J,0),  //  8..15
+		IR_P(H,1), IR_P(H,0), IR_P(D,3), IR_P(D,2), IR_P(D,1), IR_P(D,0), IR_P(A,0), IR_P(A,1),  // 16..23
+		IR_P(A,2), IR_P(A,3), IR_P(A,4), IR_P(A,5), IR_P(A,6), IR_P(A,7), IR_P(C,7), IR_P(C,6),  // 24..31
+		IR_P(C,5), IR_P(C,4), IR_P(C,3), IR_P(C,2), IR_P(C,1), IR_P(C,0), IR_P(D,7), IR_P(G,2),  // 32..39
+		IR_P(G,1), IR_P(G,0), IR_P(L,7), IR_P(L,6), IR_P(L,5), IR_P(L,4), IR_P(L,3), IR_P(L,2),  // 40..47
+		IR_P(L,1), IR_P(L,0), IR_P(B,3), IR_P(B,2), IR_P(B,1), IR_P(B,0), IR_P(F,0), IR_P(F,1),  // 48..55
+		IR_P(F,2), IR_P(F,3), IR_P(F,4), IR_P(F,5), IR_P(F,6), IR_P(F,7), IR_P(K,0), IR_P(K,1),  // 56..63
+		IR_P(K,2), IR_P(K,3), IR_P(K,4), IR_P(K,5), IR_P(K,6), IR_P(K,7),                        // 64..69
+	};
+
+// Arduino Leonardo, Micro (Teensy 2.0 has its own digitalReadFast)
+#elif defined(__AVR_ATmega32U4__) && !defined(CORE_TEENSY)
+#	define IR_PIN_MAP
+	static constexpr uint8_t  irPinMap[] = {
+		IR_P(D,2), IR_P(D,3), IR_P(D,1), IR_P(D,0), IR_P(D,4), IR_P(C,6), IR_P(D,7), IR_P(E,6),  //  0.. 7
+		IR_P(B,4), IR_P(B,5), IR_P(B,6), IR_P(B,7), IR_P(D,6), IR_P(C,7), IR_P(B,3), IR_P(B,1),  //  8..15
+		IR_P(B,2), IR_P(B,0), IR_P(F,7), IR_P(F,6), IR_P(F,5), IR_P(F,4), IR_P(F,1), IR_P(F,0),  // 16..23
+		IR_P(D,4), IR_P(D,7), IR_P(B,4), IR_P(B,5), IR_P(B,6), IR_P(D,6), IR_P(D,5),             // 24..30
+	};
+
+// ATtiny85
+#elif defined(__AVR_ATtiny85__)
+#	define IR_PIN_MAP
+	static constexpr uint8_t  irPinMap[] = {
+		IR_P(B,0), IR_P(B,1), IR_P(B,2), IR_P(B,3), IR_P(B,4), IR_P(B,5),
+	};
+
+// Arduino Duemilanove, Diecimila, Uno, Nano, Mini, Atmega8, etc
+#elif defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__) \
+   || defined(__AVR_ATmega168P__) || defined(__AVR_ATmega8__)
+#	define IR_PIN_MAP
+	static constexpr uint8_t  irPinMap[] = {
+		IR_P(D,0), IR_P(D,1), IR_P(D,2), IR_P(D,3), IR_P(D,4), IR_P(D,5), IR_P(D,6), IR_P(D,7),  //  0.. 7
+		IR_P(B,0), IR_P(B,1), IR_P(B,2), IR_P(B,3), IR_P(B,4), IR_P(B,5), IR_P(C,0), IR_P(C,1),  //  8..15
+		IR_P(C,2), IR_P(C,3), IR_P(C,4), IR_P(C,5),                                              // 16..19
+	};
+#endif
+
+#if defined(IR_PIN_MAP)
+	constexpr uint8_t  irPinPort (uint8_t pin)  { return irPinMap[pin] >> 3; }
+	constexpr uint8_t  irPinMask (uint8_t pin)  { return 1 << (irPinMap[pin] & 7); }
+
+	// With a constant port the compiler reduces this to a single IN/LDS
+	static inline  uint8_t  irPortIn (const uint8_t port)  __attribute__((always_inline));
+	static inline  uint8_t  irPortIn (const uint8_t port)
+	{
+		switch (port) {
+#			ifdef PINA
+				case IR_PORT_A:  return PINA;
+#			endif
+#			ifdef PINB
+				case IR_PORT_B:  return PINB;
+#			endif
+#			ifdef PINC
+				case IR_PORT_C:  return PINC;
+#			endif
+#			ifdef PIND
+				case IR_PORT_D:  return PIND;
+#			endif
+#			ifdef PINE
+				case IR_PORT_E:  return PINE;
+#			endif
+#			ifdef PINF
+				case IR_PORT_F:  return PINF;
+#			endif
+#			ifdef PING
+				case IR_PORT_G:  return PING;
+#			endif
+#			ifdef PINH
+				case IR_PORT_H:  return PINH;
+#			endif
+#			ifdef PINJ
+				case IR_PORT_J:  return PINJ;
+#			endif
+#			ifdef PINK
+				case IR_PORT_K:  return PINK;
+#			endif
+#			ifdef PINL
+				case IR_PORT_L:  return PINL;
+#			endif
+			default:         return 0;
+		}
+	}
+#endif
+
+//------------------------------------------------------------------------------
+// Sample the detector through the port register resolved by IRrecv(int)
+// This is what the library ISRs use; it replaces the (very slow) digitalRead()
+//
+static inline  uint8_t  irRecvLevel ( )
+{
+	return (*irparams.recvreg & irparams.recvmask) ? SPACE : MARK ;
+}
+
+//------------------------------------------------------------------------------
+// If requested, flash LED while receiving IR data
+//
+static inline  void  irBlink (volatile irparams_t *ir,  uint8_t irdata)
+{
+	if (ir->blinkflag) {
+		if (ir->blinkreg) {  // User defined LED pin
+			if (irdata == MARK)  *ir->blinkreg |=  ir->blinkmask ;
+			else                 *ir->blinkreg &= ~ir->blinkmask ;
+		} else {                  // Default LED pin for the hardware
+			if (irdata == MARK)  BLINKLED_ON() ;
+			else                 BLINKLED_OFF() ;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Close the frame in rawframes[framehead] and queue it for decode()
+// If another slot is free recording carries straight on into it (the gap timer
+//   keeps running), otherwise the state machine stops until resume().
+//
+static inline  void  irFrameDone (volatile irparams_t *ir)
+{
+#if IR_ECHO_GUARD
+	if (ir->echo) {
+		// Our own code, back off something in front of the LED
+#	if IR_STATS
+		ir->echocount++;
+#	endif
+#	if IR_STREAM
+		ir->stream      = 0;
+		ir->streamready = 0;
+#	endif
+		ir->rawlen   = 0;
+		ir->rcvstate = STATE_IDLE;
+		return;
+	}
+#endif
+#if IR_STATS
+	ir->framecount++;
+#endif
+#if IR_STREAM
+	ir->stream = 0;
+	if (ir->streamready == IR_STREAM_TAKEN) {
+		// decode() has already returned this code; do not queue it again
+		ir->streamready = 0;
+		ir->rawlen      = 0;
+		ir->rcvstate    = STATE_IDLE;
+		return;
+	}
+	ir->streamready = 0;  // Not collected in time : decode() will find it in the queue
+#endif
+
+	ir->framelen[ir->framehead] = ir->rawlen;
+	ir->frameovf[ir->framehead] = ir->overflow;
+	ir->frameseen[ir->framehead] = 0;
+
+	if (++ir->frames < RAWFRAMES) {
+		if (++ir->framehead >= RAWFRAMES)  ir->framehead = 0 ;
+		ir->rawbuf   = ir->rawframes[ir->framehead];
+		ir->rawlen   = 0;
+		ir->rcvstate = STATE_IDLE;
+	} else {
+		ir->rcvstate = STATE_STOP;
+	}
+}
+
+#if IR_EARLY_END
+//------------------------------------------------------------------------------
+// Once the header space is in : The longest frame of the protocols it may start
+//
+static inline  void  irEndLookup (volatile irparams_t *ir)
+{
+	unsigned int    mark  = ir->rawbuf[1];
+	unsigned int    space = ir->rawbuf[2];
+	const irend_t  *e;
+
+	for (uint8_t i = 0;  (e = irEnds[i]);  i++) {
+		if ((mark  < pgm_read_byte(&e->marklo))  || (mark  > pgm_read_byte(&e->markhi)))   continue ;
+		if ((space < pgm_read_byte(&e->spacelo)) || (space > pgm_read_byte(&e->spacehi)))  continue ;
+		if (IR_READ_LEN(&e->len)     > ir->endlen)    ir->endlen   = IR_READ_LEN(&e->len) ;
+		if (pgm_read_byte(&e->quiet) > ir->endquiet)  ir->endquiet = pgm_read_byte(&e->quiet) ;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Has the frame all irEndLookup() said it would, and 'ticks' of space since?
+//
+static inline  bool  irEnded (volatile irparams_t *ir,  unsigned int ticks)
+{
+	return ir->endlen && (ir->rawlen >= ir->endlen) && (ticks > ir->endquiet);
+}
+#	define IR_ENDED(ir, ticks)  irEnded((ir), (ticks))
+#else
+#	define IR_ENDED(ir, ticks)  false
+#endif
+
+//------------------------------------------------------------------------------
+// Record one interval; a full buffer flags an overflow and closes the frame
+// The caller sets the next state first, so that irFrameDone() can override it
+//
+void  irStreamStep (volatile irparams_t *ir) ;
+
+static inline  void  irRecord (volatile irparams_t *ir,  unsigned int ticks)
+{
+	if (!ir->rawlen) {
+		ir->framegap[ir->framehead] = ticks;
+#if IR_EARLY_END
+		ir->endlen   = 0;
+		ir->endquiet = 0;
+#endif
+#if IR_ECHO_GUARD
+		ir->echo = irtxled || (micros() - irtxoff < IR_ECHO_GUARD);
+#endif
+	}
+#if IR_RAW8
+	if (ticks > IR_TICK_MAX)  ticks = IR_TICK_MAX ;
+#endif
+	ir->rawbuf[ir->rawlen++] = ticks;
+#if IR_EARLY_END
+	if (ir->rawlen == 3)  irEndLookup(ir) ;
+#endif
+#if IR_STREAM
+#	if IR_ECHO_GUARD
+	if (!ir->echo)
+#	endif
+	irStreamStep(ir);
+#endif
+	if (ir->rawlen >= RAWBUF) {
+		ir->overflow = true;
+#if IR_STATS
+		ir->ovfcount++;
+#endif
+		irFrameDone(ir);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Receive state machine for IR_CAPTURE_TIMER - Called every 50uS
+// Widths of alternating SPACE, MARK are recorded in rawbuf.
+// Recorded in ticks of 50uS [microseconds, 0.000050 seconds]
+// 'rawlen' counts the number of entries recorded so far.
+// First entry is the SPACE between transmissions.
+// As soon as a the first [SPACE] entry gets long:
+//   Ready is set; State switches to IDLE; Timing of SPACE continues.
+// As soon as first MARK arrives:
+//   Gap width is recorded; Ready is cleared; New logging starts
+//
+// It is inlined in to each ISR so that the detector can be sampled without a
+// function call, which would force the ISR to save every call-used register.
+//
+static inline  void  irTimerTick (volatile irparams_t *ir,  uint8_t irdata)  __attribute__((always_inline));
+static inline  void  irTimerTick (volatile irparams_t *ir,  uint8_t irdata)
+{
+	ir->timer++;  // One more 50uS tick
+
+	switch(ir->rcvstate) {
+		//......................................................................
+		case STATE_IDLE: // In the middle of a gap
+			if (irdata == MARK) {
+				if (ir->timer < GAP_TICKS)  {  // Not big enough to be a gap.
+					ir->timer = 0;
+
+				} else {
+					// Gap just ended; Record duration; Start recording transmission
+					ir->overflow = false;
+					ir->rawlen   = 0;
+					ir->rcvstate = STATE_MARK;
+					irRecord(ir, ir->timer);
+					ir->timer    = 0;
+				}
+			}
+			break;
+		//......................................................................
+		case STATE_MARK:  // Timing Mark
+			if (irdata == SPACE) {   // Mark ended; Record time
+				ir->rcvstate = STATE_SPACE;
+				irRecord(ir, ir->timer);
+				ir->timer    = 0;
+			}
+			break;
+		//......................................................................
+		case STATE_SPACE:  // Timing Space
+			if (irdata == MARK) {  // Space just ended; Record time
+				ir->rcvstate = STATE_MARK;
+				irRecord(ir, ir->timer);
+				ir->timer    = 0;
+
+			} else if ((ir->timer > GAP_TICKS) || IR_ENDED(ir, ir->timer)) {  // Space
+					// A long Space, indicates gap between codes
+					//   (or the frame is as long as its header said, see irEndLookup)
+					// Queue the current code for processing
+					// Don't reset timer; keep counting Space width
+					irFrameDone(ir);
+			}
+			break;
+		//......................................................................
+		case STATE_STOP:  // Every slot full; Measuring Gap
+			if (irdata == MARK) {
+				if (ir->timer >= GAP_TICKS)  ir->overruns++ ;  // A new code we cannot keep
+				ir->timer = 0;  // Reset gap timer
+			}
+		 	break;
+	}
+
+	irBlink(ir, irdata);
+}
+
+//------------------------------------------------------------------------------
+// Receive state machine for IR_CAPTURE_EDGE - Called on every detector edge
+// 'irdata' is the level the detector has just changed to.
+// The time since the previous edge is taken from micros() (4uS resolution on a
+//   16MHz AVR) and rounded to the nearest 50uS tick, so rawbuf holds exactly
+//   the same units as the timer-driven capture and every decoder still works.
+// There is no interrupt while the line is idle, so the gap which ends a
+//   transmission is spotted by decode() rather than here.
+//
+static inline  void  irEdgeTick (volatile irparams_t *ir,  uint8_t irdata)
+{
+	unsigned long  now   = micros();
+	unsigned long  ticks = (now - ir->lastedge + (USECPERTICK / 2)) / USECPERTICK;
+
+	ir->lastedge = now;
+	if (ticks > 0xFFFF)  ticks = 0xFFFF ;  // Saturate long gaps rather than wrap
+
+	switch(ir->rcvstate) {
+		//......................................................................
+		case STATE_IDLE: // In the middle of a gap
+			if ((irdata == MARK) && (ticks >= GAP_TICKS)) {
+				// Gap just ended; Record duration; Start recording transmission
+				ir->overflow = false;
+				ir->rawlen   = 0;
+				ir->rcvstate = STATE_MARK;
+				irRecord(ir, ticks);
+			}
+			break;
+		//......................................................................
+		case STATE_MARK:  // Timing Mark
+			if (irdata == SPACE) {   // Mark ended; Record time
+				ir->rcvstate = STATE_SPACE;
+				irRecord(ir, ticks);
+			}
+			break;
+		//......................................................................
+		case STATE_SPACE:  // Timing Space
+			if (irdata == MARK) {
+				if (ticks > GAP_TICKS) {
+					// The gap was not noticed before this Mark arrived
+					// Queue the current code; Start the next one in a free slot
+					irFrameDone(ir);
+					if (ir->rcvstate == STATE_IDLE) {
+						ir->overflow = false;
+						ir->rcvstate = STATE_MARK;
+						irRecord(ir, ticks);
+					} else {
+						ir->overruns++;
+					}
+				} else {
+					// Space just ended; Record time
+					ir->rcvstate = STATE_MARK;
+					irRecord(ir, ticks);
+				}
+			}
+			break;
+		//......................................................................
+		case STATE_STOP:  // Every slot full; Measuring Gap (lastedge restarts the gap)
+			if ((irdata == MARK) && (ticks >= GAP_TICKS))  ir->overruns++ ;  // A new code we cannot keep
+			break;
+	}
+
+	irBlink(ir, irdata);
+}
+
+#if IR_RECEIVERS > 1
+//------------------------------------------------------------------------------
+// Timer capture of every receiver - Called every 50uS
+// Each port is read once, up front, so receivers on one port cost one read
+//   and all of them see the same instant.  Then each enabled receiver's state
+//   machine runs on its own bit.
+//
+static inline  void  irTimerTickAll ( )
+{
+	uint8_t  pins[IR_RECEIVERS];
+
+	for (uint8_t i = 0;  i < irNumPorts;  i++)  pins[i] = *irPorts[i] ;
+
+	for (uint8_t r = 0;  r < IR_RECEIVERS;  r++) {
+		volatile irparams_t  *ir = &irrecvs[r];
+		if (ir->rcvstate && (ir->capture == IR_CAPTURE_TIMER))
+			irTimerTick(ir, (pins[ir->recvport] & ir->recvmask) ? SPACE : MARK);
+	}
+}
+#endif
+
+// Edge-triggered capture handler for IRrecv(int), attached in IR_CAPTURE_EDGE mode
+void  irEdgeISR ( ) ;
+
+//------------------------------------------------------------------------------
+// By default the library provides the timer ISR and samples the runtime pin.
+// Set IR_SKETCH_ISR to 1 (eg. with -DIR_SKETCH_ISR=1) to leave the timer ISR
+//   to the sketch, which then adds  IR_RECV_ISR(pin)  to sample a constant pin.
+//
+#ifndef IR_SKETCH_ISR
+#	define IR_SKETCH_ISR  0
+#endif
+
+#if IR_SEND_QUEUE
+#	define IR_RECV_ISR(pin)  \
+	ISR (TIMER_INTR_NAME) { TIMER_RESET; if (irSendStep()) return; IR_BLAST_STEP(); \
+		if (IR_TIMER_RECEIVING(&irparams)) irTimerTick(&irparams, IRrecvPin<pin>::level()); IR_ISR_TIMED(); }
+#else
+#	define IR_RECV_ISR(pin)  \
+	ISR (TIMER_INTR_NAME) { TIMER_RESET; IR_BLAST_STEP(); \
+		if (IR_TIMER_RECEIVING(&irparams)) irTimerTick(&irparams, IRrecvPin<pin>::level()); IR_ISR_TIMED(); }
+#endif
+
 //------------------------------------------------------------------------------
 // Define which timer to use
 //
@@ -235,6 +1016,7 @@ EXTERN  volatile irparams_t  irparams;
 
 //-----------------
 #if (TIMER_COUNT_TOP < 256)
+#	define TIMER_CYCLES  (TCNT2)
 #	define TIMER_CONFIG_NORMAL() ({ \
 		TCCR2A = _BV(WGM21); \
 		TCCR2B = _BV(CS20); \
@@ -242,6 +1024,7 @@ EXTERN  volatile irparams_t  irparams;
 		TCNT2  = 0; \
 	})
 #else
+#	define TIMER_CYCLES  (TCNT2 * 8)
 #	define TIMER_CONFIG_NORMAL() ({ \
 		TCCR2A = _BV(WGM21); \
 		TCCR2B = _BV(CS21); \
@@ -297,6 +1080,8 @@ EXTERN  volatile irparams_t  irparams;
 	TCNT1  = 0; \
 })
 
+#define TIMER_CYCLES  (TCNT1)
+
 //-----------------
 #if defined(CORE_OC1A_PIN)
 #	define TIMER_PWM_PIN  CORE_OC1A_PIN  // Teensy
@@ -337,6 +1122,8 @@ EXTERN  volatile irparams_t  irparams;
   TCNT3 = 0; \
 })
 
+#define TIMER_CYCLES  (TCNT3)
+
 //-----------------
 #if defined(CORE_OC3A_PIN)
 #	define TIMER_PWM_PIN  CORE_OC3A_PIN  // Teensy
@@ -419,6 +1206,8 @@ EXTERN  volatile irparams_t  irparams;
   TCNT4 = 0; \
 })
 
+#define TIMER_CYCLES  (TCNT4)
+
 //-----------------
 #if defined(CORE_OC4A_PIN)
 #	define TIMER_PWM_PIN  CORE_OC4A_PIN
@@ -455,6 +1244,8 @@ EXTERN  volatile irparams_t  irparams;
   TCNT5 = 0; \
 })
 
+#define TIMER_CYCLES  (TCNT5)
+
 //-----------------
 #if defined(CORE_OC5A_PIN)
 #	define TIMER_PWM_PIN  CORE_OC5A_PIN
@@ -576,6 +1367,7 @@ EXTERN  volatile irparams_t  irparams;
 })
 #define TIMER_COUNT_TOP      (SYSCLOCK * USECPERTICK / 1000000)
 #if (TIMER_COUNT_TOP < 256)
+#define TIMER_CYCLES  (TCNT0)
 #define TIMER_CONFIG_NORMAL() ({ \
   TCCR0A = _BV(WGM01); \
   TCCR0B = _BV(CS00); \
@@ -583,6 +1375,7 @@ EXTERN  volatile irparams_t  irparams;
   TCNT0 = 0; \
 })
 #else
+#define TIMER_CYCLES  (TCNT0 * 8)
 #define TIMER_CONFIG_NORMAL() ({ \
   TCCR0A = _BV(WGM01); \
   TCCR0B = _BV(CS01); \
@@ -599,4 +1392,203 @@ EXTERN  volatile irparams_t  irparams;
 #else
 #	error "Internal code configuration error, no known IR_USE_TIMER# defined\n"
 #endif
+
+//------------------------------------------------------------------------------
+// Does the timer ISR have receivers to sample?
+//
+static inline  bool  irTimerReceivers ( )
+{
+	for (uint8_t r = 0;  r < IR_RECEIVERS;  r++) {
+		if (irrecvs[r].rcvstate && (irrecvs[r].capture == IR_CAPTURE_TIMER))  return true ;
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------------
+// IR blaster : Every 16 bit timer the library is not using makes the carrier
+//   for an emitter of its own, on its OCnA pin.  The marks and spaces of all
+//   of them are timed by the library's timer ISR, tick by tick, alongside the
+//   receivers.  See IRblaster in IRremote.h and irBlaster.cpp.
+//
+#if IR_BLASTER && (defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__))
+#	if defined(IR_USE_TIMER1) || defined(IR_USE_TIMER3) || defined(IR_USE_TIMER4) || defined(IR_USE_TIMER5)
+#		define IR_BLAST_CHANNELS  3  // Of timers 1, 3, 4 and 5 : Pins 11, 5, 6 and 46
+#	else
+#		define IR_BLAST_CHANNELS  4
+#	endif
+#elif IR_BLASTER && (defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__))
+#	if defined(IR_USE_TIMER1)
+#		define IR_BLAST_CHANNELS  0
+#	else
+#		define IR_BLAST_CHANNELS  1  // Timer 1 : Pin 9
+#	endif
+#else
+#	define IR_BLAST_CHANNELS  0
+#endif
+
+#if IR_BLAST_CHANNELS
+typedef
+	struct {
+		volatile uint8_t  *tccra;    // The timer's TCCRnA, whose COMnA1 puts the carrier on the pin
+		const uint8_t     *ticks;    // Intervals of the frame going out
+		uint8_t            progmem;  //   are in PROGMEM
+		uint8_t            len;      // Intervals in the frame
+		uint8_t            i;        // Next one; len + 1 once the gap after the copy has begun
+		uint8_t            repeats;  // Copies still to send after this one
+		uint8_t            gap;      // Silence after each copy (mS)
+		unsigned int       left;     // Ticks to the next interval; 0 : Idle
+	}
+irblast_t;
+
+typedef
+	struct {
+		const uint8_t  *frame;     // IR_FRAME_... / IRrawFrame / irProntoParse()
+		uint8_t         channel;
+		uint8_t         progmem;
+		uint8_t         repeats;
+		uint8_t         gap;
+	}
+irblastq_t;
+
+// The emitters, and the frames waiting for them in the order they were sent
+EXTERN  volatile irblast_t   irblast[IR_BLAST_CHANNELS];
+EXTERN  volatile irblastq_t  irblastq[IR_BLASTER];
+EXTERN  volatile uint8_t     irblastcount;  // Frames in irblastq[]
+EXTERN  volatile uint8_t     irblastbusy;   // Bit n : Emitter n is sending
+
+void  irBlastNext (uint8_t channel) ;
+
+//------------------------------------------------------------------------------
+// Called by the timer ISR every tick : Count down each emitter's interval, and
+//   turn to the next one when it ends
+//
+static inline  void  irBlastStep ( )
+{
+	if (!irblastbusy)  return ;
+
+	for (uint8_t c = 0;  c < IR_BLAST_CHANNELS;  c++) {
+		volatile irblast_t  *ch = &irblast[c];
+		if (ch->left && !--ch->left)  irBlastNext(c) ;
+	}
+}
+
+#	define IR_BLAST_STEP()  irBlastStep()
+// The ISR also runs for the blaster alone, with receivers off or on edge capture
+#	define IR_TIMER_RECEIVING(ir)  ((ir)->rcvstate && ((ir)->capture == IR_CAPTURE_TIMER))
+#else
+#	define IR_BLAST_STEP()
+#	define IR_TIMER_RECEIVING(ir)  1  // The ISR only runs for timer capture
+#endif
+
+//------------------------------------------------------------------------------
+// Full duplex : Give the timer back to the receivers after sending
+// Called by IRrecv::decode() after a blocking send, and by irSendStep() from
+//   the ISR when the asynchronous queue has gone out.  The frames they had
+//   queued are kept; each starts again by waiting for a gap, which lets the
+//   tail of our own code die away in the detector.
+//
+static inline  void  irRecvResume ( )
+{
+	irtxtimer = 0;
+	TIMER_DISABLE_PWM;
+	TIMER_CONFIG_NORMAL();
+
+	for (uint8_t r = 0;  r < IR_RECEIVERS;  r++) {
+		volatile irparams_t  *ir = &irrecvs[r];
+		if (ir->capture != IR_CAPTURE_TIMER)  continue ;  // Edge capture never stopped
+		if ((ir->rcvstate == STATE_MARK) || (ir->rcvstate == STATE_SPACE)) {
+			ir->rawlen   = 0;  // Cut off by the send : Drop it
+			ir->rcvstate = STATE_IDLE;
+		}
+		ir->timer = 0;
+	}
+
+	TIMER_RESET;
+	TIMER_ENABLE_INTR;
+}
+
+#if IR_SEND_QUEUE
+//------------------------------------------------------------------------------
+// Entry i of a queued frame, in uS
+//
+static inline  unsigned int  irSendEntry (volatile irsendq_t *f,  unsigned int i)
+{
+	switch (f->kind) {
+		case IR_SENDQ_RAM:  return ((const unsigned int *)f->buf)[i] ;
+		case IR_SENDQ_P:    return pgm_read_word((const unsigned int *)f->buf + i) ;
+		case IR_SENDQ_RAM8: return ((const uint8_t *)f->buf)[i] * USECPERTICK ;
+		default:            return pgm_read_byte((const uint8_t *)f->buf + i) * USECPERTICK ;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Asynchronous send - Called by the timer ISR, which IRsend::enableIROut() has
+//   set to run the carrier, so it fires once or twice per carrier cycle
+// Returns false when nothing is being sent, for the ISR to sample receivers.
+// Each mark or space ends at a micros() deadline counted on from the last
+//   one, so the ISR's own jitter never adds up over a frame.
+//
+static inline  bool  irSendStep ( )
+{
+	if (!irsendcount)                         return false ;
+	if ((long)(micros() - irsendend) < 0)     return true ;   // Still in this mark or space
+
+	volatile irsendq_t  *f = &irsendq[irsendhead];
+
+	// Next mark or space; one of 0 leaves the LED as it is
+	while (irsendi < f->len) {
+		unsigned int  usec = irSendEntry(f, irsendi);
+		if (usec) {
+			if (irsendi & 1) {
+				TIMER_DISABLE_PWM;
+				irtxled = 0;
+				irtxoff = micros();
+			} else {
+				TIMER_ENABLE_PWM;
+				irtxled = 1;
+			}
+			irsendend += usec;
+			irsendi++;
+			return true;
+		}
+		irsendi++;
+	}
+
+	// End of a copy : LED off for the gap, then the next copy or frame
+	TIMER_DISABLE_PWM;
+	if (irtxled) {
+		irtxled = 0;
+		irtxoff = micros();
+	}
+	irsendend += f->gap * 1000UL;
+	irsendi    = 0;
+	if (f->repeats) {
+		f->repeats--;
+	} else if (--irsendcount) {
+		if (++irsendhead == IR_SEND_QUEUE)  irsendhead = 0 ;
+		if (irsendq[irsendhead].khz != f->khz)  TIMER_CONFIG_KHZ(irsendq[irsendhead].khz) ;
+	} else if (irtxtimer) {
+		irRecvResume();      // All sent : Back to sampling the receivers
+	} else {
+		TIMER_DISABLE_INTR;  // All sent
+	}
+	return true;
+}
+#endif
+
+//------------------------------------------------------------------------------
+// The timer ISR ends with IR_ISR_TIMED() to keep its longest run in irIsrMax
+// In CTC mode the timer has counted up from 0 since the tick which raised the
+//   interrupt, so TIMER_CYCLES is the time taken so far, getting into the ISR
+//   included.  Timers without TIMER_CYCLES are not timed.
+//
+#if IR_STATS && defined(TIMER_CYCLES)
+#	define IR_ISR_TIMED()  do { \
+		unsigned int  cycles = TIMER_CYCLES; \
+		if (cycles > irIsrMax)  irIsrMax = cycles ; \
+	} while (0)
+#else
+#	define IR_ISR_TIMED()
+#endif
+
 #endif
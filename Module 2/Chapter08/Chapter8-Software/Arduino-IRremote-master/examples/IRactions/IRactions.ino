@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+// IRactions : Turn remote buttons into action numbers with a code table
+//
+// Buttons of known remotes are listed in flash.  Buttons of any other remote
+// (including ones that only decode to an UNKNOWN hash) can be learned at run
+// time into EEPROM : send "L3" on the serial monitor, then press a button to
+// make it action 3.  "F" then a button forgets it, "C" forgets them all.
+//
+#include <IRremote.h>
+
+int  RECV_PIN = 11;
+
+IRrecv          irrecv(RECV_PIN);
+decode_results  results;
+
+// Known buttons, in order of value (the table is binary searched)
+const ircode_t  known[] PROGMEM = {
+  IR_CODE_ADDRESS(PANASONIC, 0x4004, 0x0100BCBD, 1),  // Panasonic TV power
+  IR_CODE(NEC,     0x20DF10EF, 1),  // LG TV power
+  IR_CODE(NEC,     0x20DF40BF, 2),  // LG TV volume up
+  IR_CODE(SAMSUNG, 0xE0E040BF, 1),  // Samsung TV power
+  IR_CODE(SAMSUNG, 0xE0E0E01F, 2),  // Samsung TV volume up
+};
+IRcodesPROGMEM  knownCodes(known, sizeof(known) / sizeof(known[0]));
+
+// Learned buttons : Up to 100 of them, from EEPROM address 0
+IRcodesEEPROM   learnedCodes(0, 100);
+
+char     mode   = 0;  // 'L' or 'F' while waiting for a button
+uint8_t  action = 0;  // Action to learn
+
+//+=============================================================================
+void  setup ( )
+{
+  Serial.begin(9600);
+  if (!knownCodes.sorted())  Serial.println("known[] is out of order") ;
+  Serial.print(learnedCodes.count(), DEC);
+  Serial.println(" learned buttons");
+  irrecv.enableIRIn();
+}
+
+//+=============================================================================
+void  loop ( )
+{
+  // Commands
+  if (Serial.available()) {
+    char  c = toupper(Serial.read());
+    if (c == 'L') {
+      mode   = c;
+      action = Serial.parseInt();
+    } else if (c == 'F') {
+      mode   = c;
+    } else if (c == 'C') {
+      learnedCodes.clear();
+      Serial.println("Forgot all learned buttons");
+    }
+  }
+
+  if (!irrecv.decode(&results))  return ;
+
+  if (mode == 'L') {
+    Serial.println(learnedCodes.learn(&results, action) ? "Learned" : "No room");
+    mode = 0;
+
+  } else if (mode == 'F') {
+    Serial.println(learnedCodes.forget(&results) ? "Forgotten" : "Not learned");
+    mode = 0;
+
+  } else if (results.value != REPEAT) {
+    int  a = learnedCodes.lookup(&results);
+    if (a == IR_NO_ACTION)  a = knownCodes.lookup(&results) ;
+
+    switch (a) {
+      case IR_NO_ACTION:  Serial.println("Unknown button");  break ;
+      case 1:             Serial.println("Power");           break ;
+      case 2:             Serial.println("Volume up");       break ;
+      default:            Serial.print("Action ");  Serial.println(a, DEC);  break ;
+    }
+  }
+
+  irrecv.resume();
+}
@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+// IRblaster : One emitter per device in the rack, all sending at once
+//
+// An Arduino Mega drives four emitters, one on each spare timer : Pins 11, 5,
+// 6 and 46.  Each sits in front of one device.  IRsend would send the four
+// codes one after the other; the blaster sends them together, each emitter
+// at its own protocol's carrier, so switching the whole rack to "TV" takes no
+// longer than the slowest code.
+//
+// Needs IR_BLASTER set in IRremoteInt.h, eg. to 8 (or -DIR_BLASTER=8) : The
+// blaster is left out of the library by default.
+//
+// Send a digit 0..3 on the serial monitor to send one device its code again.
+//
+#include <IRremote.h>
+
+#if IR_BLAST_CHANNELS < 4
+#	error "Needs an Arduino Mega, and IR_BLASTER set to 8 in IRremoteInt.h"
+#endif
+
+IRblaster  blaster;
+
+// One code per device, built by the compiler (see IR_FRAME_... in IRremote.h)
+const uint8_t  tv[]        PROGMEM = { IR_FRAME_SAMSUNG(0xE0E0D02F) };
+const uint8_t  amplifier[] PROGMEM = { IR_FRAME_NEC(0x5EA1D827) };
+const uint8_t  player[]    PROGMEM = { IR_FRAME_SONY(0x5A, 12) };
+const uint8_t  tuner[]     PROGMEM = { IR_FRAME_RC5(0x3F, 12) };
+
+const uint8_t  *codes[]  = { tv, amplifier, player, tuner };
+const uint8_t   copies[] = { 1, 0, 2, 0 };  // Sony wants three copies
+
+//+=============================================================================
+void  sendAll ( )
+{
+  unsigned long  start = millis();
+
+  // Two copies of the TV code 40 mS apart... while the others go out as well
+  for (uint8_t c = 0;  c < 4;  c++)  blaster.send_P(c, codes[c], copies[c], 40) ;
+  while (blaster.sending()) ;
+
+  Serial.print("Rack switched in ");
+  Serial.print(millis() - start, DEC);
+  Serial.println(" mS");
+}
+
+//+=============================================================================
+void  setup ( )
+{
+  Serial.begin(9600);
+  for (uint8_t c = 0;  c < blaster.channels();  c++) {
+    Serial.print("Emitter ");
+    Serial.print(c, DEC);
+    Serial.print(" on pin ");
+    Serial.println(blaster.pin(c), DEC);
+  }
+
+  sendAll();
+}
+
+//+=============================================================================
+void  loop ( )
+{
+  if (Serial.available()) {
+    int  c = Serial.read() - '0';
+    if ((c >= 0) && (c < 4) && !blaster.send_P(c, codes[c], copies[c], 40))
+      Serial.println("Queue full");
+  }
+}
@@ -0,0 +1,44 @@
+//------------------------------------------------------------------------------
+// IRcallbacks : Let the library call you with each code
+//
+// Register a handler per protocol with onDecode(), then call dispatch() from
+// loop().  dispatch() returns at once unless a whole frame has come in, and
+// since only NEC and Sony have handlers here, no other decoder is ever run.
+//
+#include <IRremote.h>
+
+int  RECV_PIN = 11;
+
+IRrecv  irrecv(RECV_PIN);
+
+//+=============================================================================
+void  onNEC (decode_results *results)
+{
+  if (results->value == REPEAT)  return ;  // Button held
+  Serial.print("NEC  ");
+  Serial.println(results->value, HEX);
+}
+
+//+=============================================================================
+void  onSony (decode_results *results)
+{
+  Serial.print("Sony ");
+  Serial.println(results->value, HEX);
+}
+
+//+=============================================================================
+void  setup ( )
+{
+  Serial.begin(9600);
+  irrecv.onDecode(NEC,  onNEC);
+  irrecv.onDecode(SONY, onSony);
+  irrecv.enableIRIn();
+}
+
+//+=============================================================================
+void  loop ( )
+{
+  irrecv.dispatch();
+
+  // ... the rest of the sketch, never blocked waiting for IR
+}
@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+// IRdecodeBenchmark : Time IRrecv::decode() over a mixed set of recorded codes
+//
+// No IR hardware is needed; the codes below are fed straight into the
+// receive queue.  For each code the worst and average decode time is printed,
+// followed by the worst case over the whole set.  The unknown codes are the
+// slowest, as they fall all the way through to the hash decoder.
+//
+#include <IRremote.h>
+#include <IRremoteInt.h>
+
+//------------------------------------------------------------------------------
+// Recorded codes : Intervals in 50uS ticks, starting with the header mark
+//
+const uint8_t  codeNEC[]     PROGMEM = {182,88,14,9,13,9,13,32,13,9,13,9,14,9,13,9,13,9,13,32,13,32,13,9,13,32,13,32,13,32,13,32,13,32,13,9,13,9,13,9,14,31,14,9,13,9,13,9,13,9,14,31,14,31,13,32,13,9,14,31,13,32,13,32,13,32,13};
+const uint8_t  codeNECrpt[]  PROGMEM = {182,43,14};
+const uint8_t  codeSony[]    PROGMEM = {50,10,26,10,14,10,26,10,14,10,26,10,14,10,14,10,25,10,14,10,14,10,14,10,14};
+const uint8_t  codeRC5[]     PROGMEM = {20,16,37,16,20,16,19,34,19,16,38,33,37,34,37,34,19,16,20};
+const uint8_t  codeRC6[]     PROGMEM = {56,15,11,16,11,7,10,7,11,16,19,7,11,7,11,7,10,7,11,7,11,6,11,7,11,7,11,6,11,7,11,7,10,7,20,7,11,15,11,7,11};
+const uint8_t  codeJVC[]     PROGMEM = {162,78,14,30,14,30,14,9,14,9,14,9,14,30,14,9,13,30,14,30,14,30,14,30,14,9,14,30,14,9,14,9,14,8,14};
+const uint8_t  codeSamsung[] PROGMEM = {102,98,14,29,14,30,13,30,13,9,13,9,13,9,14,9,13,9,13,30,13,30,13,30,13,10,13,9,13,9,13,9,14,9,13,9,13,30,13,9,13,10,13,9,13,9,13,9,14,9,13,30,13,9,13,30,13,30,13,30,13,30,14,29,14,30,13};
+const uint8_t  codeDenon[]   PROGMEM = {8,13,8,34,8,13,8,34,8,13,8,34,8,13,8,13,7,34,8,13,8,13,8,34,8,34,8,13,8,13,8};
+const uint8_t  codeSharp[]   PROGMEM = {7,34,7,14,7,14,7,13,7,14,7,34,7,14,6,14,7,34,7,14,7,14,6,14,7,14,7,34,7,13,7};
+const uint8_t  codeOther[]   PROGMEM = {60,30,20,20,20,40,20,20,20,40,20,40,20,20,20,20,20,40,20,20,20,40,20,20,20,40,20};
+
+struct code_t {
+  const char     *name;
+  const uint8_t  *ticks;
+  uint8_t        len;
+};
+
+#define CODE(name)  { #name, code##name, sizeof(code##name) }
+
+const code_t  codes[] = {
+  CODE(NEC), CODE(NECrpt), CODE(Sony), CODE(RC5), CODE(RC6),
+  CODE(JVC), CODE(Samsung), CODE(Denon), CODE(Sharp), CODE(Other),
+};
+
+#define RUNS  100  // Decodes timed per code
+
+IRrecv  irrecv(0);
+
+//+=============================================================================
+// Queue one recorded code, exactly as the receive ISR would have left it
+//
+void  inject (const code_t *code)
+{
+  irparams.framegap[irparams.framehead] = 1200;  // 60mS gap before the code
+  for (uint8_t i = 0;  i < code->len;  i++)
+    irparams.rawbuf[i + 1] = pgm_read_byte(code->ticks + i);
+  irparams.rawlen   = code->len + 1;
+  irparams.overflow = false;
+  irFrameDone(&irparams);
+}
+
+//+=============================================================================
+// Configure the Arduino
+//
+void  setup ( )
+{
+  Serial.begin(9600);
+  // The receiver is deliberately not enabled, so nothing else touches irparams
+}
+
+//+=============================================================================
+// Time every code, then the whole set
+//
+void  loop ( )
+{
+  decode_results  results;
+  unsigned long   worst = 0;
+
+  Serial.println("code       type  worst(uS)  mean(uS)");
+  for (uint8_t c = 0;  c < sizeof(codes) / sizeof(codes[0]);  c++) {
+    unsigned long  max = 0;
+    unsigned long  sum = 0;
+
+    for (int run = 0;  run < RUNS;  run++) {
+      inject(&codes[c]);
+      unsigned long  start = micros();
+      irrecv.decode(&results);
+      unsigned long  took  = micros() - start;
+      irrecv.resume();
+
+      sum += took;
+      if (took > max)  max = took ;
+    }
+    if (max > worst)  worst = max ;
+
+    Serial.print(codes[c].name);
+    for (int pad = strlen(codes[c].name);  pad < 11;  pad++)  Serial.print(" ");
+    Serial.print(results.decode_type, DEC);
+    Serial.print("\t");
+    Serial.print(max, DEC);
+    Serial.print("\t");
+    Serial.println(sum / RUNS, DEC);
+  }
+  Serial.print("Worst case over all codes: ");
+  Serial.print(worst, DEC);
+  Serial.println(" uS");
+  Serial.println("");
+
+  delay(5000);
+}
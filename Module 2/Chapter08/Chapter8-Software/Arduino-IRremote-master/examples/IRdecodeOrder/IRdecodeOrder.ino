@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+// IRdecodeOrder : The receiver learns which remotes it sees
+//
+// With IR_ADAPT_ORDER, decode() tries the decoders of the protocols it sees
+// most first.  The order is kept in EEPROM once an hour, so after a restart
+// the receiver does not have to learn it again.
+//
+// Send "O" on the serial monitor to print the order.
+//
+#include <IRremote.h>
+
+#define ORDER_ADDRESS  0  // 1 + IR_DECODERS bytes of EEPROM
+
+int  RECV_PIN = 11;
+
+IRrecv          irrecv(RECV_PIN);
+decode_results  results;
+unsigned long   saved;
+
+// Names by decode_type + 1
+const char  *names[IR_TYPES] = {
+  "UNKNOWN", "UNUSED", "RC5", "RC6", "NEC", "SONY", "PANASONIC", "JVC",
+  "SAMSUNG", "WHYNTER", "AIWA_RC_T501", "LG", "SANYO", "MITSUBISHI", "DISH",
+  "SHARP", "DENON", "PRONTO", "PULSE_DISTANCE"
+};
+
+//+=============================================================================
+void  setup ( )
+{
+  Serial.begin(9600);
+  if (!irrecv.loadOrder(ORDER_ADDRESS))  Serial.println("No order kept yet") ;
+  irrecv.enableIRIn();
+}
+
+//+=============================================================================
+void  printOrder ( )
+{
+  decode_type_t  types[IR_DECODERS];
+  int            n = irrecv.decodeOrder(types);
+
+  for (int i = 0;  i < n;  i++) {
+    Serial.print(names[types[i] + 1]);
+    Serial.print(" ");
+  }
+  Serial.println("");
+}
+
+//+=============================================================================
+void  loop ( )
+{
+  if (Serial.available() && (toupper(Serial.read()) == 'O'))  printOrder() ;
+
+  if (irrecv.decode(&results)) {
+    Serial.println(results.value, HEX);
+    irrecv.resume();
+  }
+
+  // EEPROM wears out : Only write now and then (and only the bytes which changed)
+  if (millis() - saved > 3600000UL) {
+    irrecv.saveOrder(ORDER_ADDRESS);
+    saved = millis();
+  }
+}
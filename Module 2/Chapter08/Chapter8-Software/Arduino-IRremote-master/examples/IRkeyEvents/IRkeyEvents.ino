@@ -0,0 +1,46 @@
+//------------------------------------------------------------------------------
+// IRkeyEvents : Button presses rather than IR frames
+//
+// Prints one line when a button goes down, one every IR_KEY_RATE mS while it
+// is held (after IR_KEY_DELAY mS) and one when it is let go, for any remote :
+// no REPEAT values, toggle bits or delay() to deal with.
+//
+#include <IRremote.h>
+
+int  RECV_PIN = 11;
+
+IRrecv   irrecv(RECV_PIN);
+IRkeys   keys(&irrecv);
+irkey_t  key;
+
+//+=============================================================================
+void  setup ( )
+{
+  Serial.begin(9600);
+  irrecv.enableIRIn();
+}
+
+//+=============================================================================
+void  loop ( )
+{
+  if (!keys.event(&key))  return ;
+
+  switch (key.event) {
+    case IR_KEY_DOWN:    Serial.print("Down   ");  break ;
+    case IR_KEY_REPEAT:  Serial.print("Repeat ");  break ;
+    case IR_KEY_UP:      Serial.print("Up     ");  break ;
+  }
+  Serial.print(key.value, HEX);
+
+  if (key.event == IR_KEY_UP) {
+    // How the remote repeats : Frames every period() mS
+    Serial.print(" held ");
+    Serial.print(key.held, DEC);
+    Serial.print(" mS, ");
+    Serial.print(keys.frames(), DEC);
+    Serial.print(" frames, ");
+    Serial.print(keys.period(), DEC);
+    Serial.print(" mS apart");
+  }
+  Serial.println("");
+}
@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+// IRmultiRecv : One detector per room, all on one board
+//
+// Needs IR_RECEIVERS set to 4 in IRremoteInt.h (or -DIR_RECEIVERS=4).  Every
+// receiver records and decodes on its own; the timer ISR samples them all,
+// reading each port once per tick.
+//
+// At start up it times the ISR with 1, 2 and then 4 receivers enabled, and
+// prints the longest ISR IR_STATS has seen.  Send "T" on the serial monitor
+// to time it again with all four.
+//
+#include <IRremote.h>
+#include <IRremoteInt.h>
+
+#if IR_RECEIVERS < 4
+#	error "Set IR_RECEIVERS to 4 in IRremoteInt.h"
+#endif
+
+// Pins 10..13 are all on port B of a Mega, so the ISR reads one register
+IRrecv  kitchen(10);
+IRrecv  lounge(11);
+IRrecv  bedroom(12);
+IRrecv  office(13);
+
+IRrecv      *rooms[] = { &kitchen, &lounge, &bedroom, &office };
+const char  *names[] = { "Kitchen", "Lounge", "Bedroom", "Office" };
+
+decode_results  results;
+
+//+=============================================================================
+// Average time of one idle timer tick, in nS, and the longest ISR so far
+//
+void  timeISR (uint8_t receivers)
+{
+  TIMER_DISABLE_INTR;  // Stop the library's ISR, leave millis()/micros() running
+  unsigned long  start = micros();
+  for (int i = 0;  i < 1000;  i++)  irTimerTickAll() ;
+  unsigned long  took  = micros() - start;  // uS for 1000 ticks : nS per tick
+  TIMER_ENABLE_INTR;
+
+  delay(100);  // Let the ISR run a while to time itself
+  irstats_t  st;
+  kitchen.stats(&st);
+
+  Serial.print(receivers, DEC);
+  Serial.print(" receivers on ");
+  Serial.print(irNumPorts, DEC);
+  Serial.print(" ports : ");
+  Serial.print(took, DEC);
+  Serial.print(" nS per tick, longest ISR ");
+  Serial.print(st.isrmax, DEC);
+  Serial.println(" cycles");
+}
+
+//+=============================================================================
+void  setup ( )
+{
+  Serial.begin(9600);
+  for (uint8_t i = 0;  i < 4;  i++) {
+    rooms[i]->enableIRIn();
+    if (i != 2) {  // 1, 2 and 4 receivers
+      kitchen.clearStats();
+      timeISR(i + 1);
+    }
+  }
+}
+
+//+=============================================================================
+void  loop ( )
+{
+  if (Serial.available() && (toupper(Serial.read()) == 'T'))  timeISR(4) ;
+
+  for (uint8_t i = 0;  i < 4;  i++) {
+    if (rooms[i]->decode(&results)) {
+      Serial.print(names[i]);
+      Serial.print(" : ");
+      Serial.println(results.value, HEX);
+      rooms[i]->resume();
+    }
+  }
+}
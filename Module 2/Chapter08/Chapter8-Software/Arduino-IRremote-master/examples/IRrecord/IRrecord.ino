@@ -39,6 +39,8 @@ int codeType = -1; // The type of code
 unsigned long codeValue; // The code value if not raw
 unsigned int rawCodes[RAWBUF]; // The durations if raw
 int codeLen; // The length of the code
+uint8_t codeData[IR_DATA_BYTES]; // The bits of a long pulse distance code
+irpulses_t codePulses; // And its timing
 int toggle = 0; // The RC5/6 toggle state
 
 // Stores the code for later playback
@@ -86,6 +88,14 @@ void storeCode(decode_results *results) {
     else if (codeType == RC6) {
       Serial.print("Received RC6: ");
     } 
+    else if (codeType == PULSE_DISTANCE) {
+      // Too long for a value : Keep every bit, and the timing to send them with
+      Serial.print("Received pulse distance, ");
+      Serial.print(results->bits, DEC);
+      Serial.print(" bits, ending ");
+      memcpy(codeData, results->data, sizeof(codeData));
+      codePulses = results->pulses;
+    } 
     else {
       Serial.print("Unexpected codeType ");
       Serial.print(codeType, DEC);
@@ -133,6 +143,11 @@ void sendCode(int repeat) {
       Serial.println(codeValue, HEX);
     }
   } 
+  else if (codeType == PULSE_DISTANCE) {
+    irsend.sendPulseDistance(&codePulses, codeData, codeLen, 38);
+    Serial.print("Sent pulse distance ");
+    Serial.println(codeValue, HEX);
+  } 
   else if (codeType == UNKNOWN /* i.e. raw */) {
     // Assume 38 KHz
     irsend.sendRaw(rawCodes, codeLen, 38);
@@ -146,8 +161,7 @@ void loop() {
   // If button pressed, send the code.
   int buttonState = digitalRead(BUTTON_PIN);
   if (lastButtonState == HIGH && buttonState == LOW) {
-    Serial.println("Released");
-    irrecv.enableIRIn(); // Re-enable receiver
+    Serial.println("Released"); // The receiver picks up again by itself
   }
 
   if (buttonState) {
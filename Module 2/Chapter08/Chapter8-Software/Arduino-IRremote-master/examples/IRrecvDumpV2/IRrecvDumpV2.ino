@@ -29,6 +29,15 @@ void  ircode (decode_results *results)
     Serial.print(":");
   }
 
+  // Codes longer than 32 bits : Print every byte
+  if (results->bits > 32) {
+    for (int i = 0;  i < (results->bits + 7) / 8;  i++) {
+      if (results->data[i] < 0x10)  Serial.print("0") ;
+      Serial.print(results->data[i], HEX);
+    }
+    return;
+  }
+
   // Print Code
   Serial.print(results->value, HEX);
 }
@@ -56,6 +65,7 @@ void  encoding (decode_results *results)
     case AIWA_RC_T501: Serial.print("AIWA_RC_T501");  break ;
     case PANASONIC:    Serial.print("PANASONIC");     break ;
     case DENON:        Serial.print("Denon");         break ;
+    case PULSE_DISTANCE: Serial.print("PULSE_DISTANCE"); break ;
   }
 }
 
@@ -0,0 +1,36 @@
+//------------------------------------------------------------------------------
+// IRrecvProtocols : A receiver built for the remotes you have
+//
+// Only the NEC, Samsung and RC5 decoders end up in this sketch, tried in that
+// order, without touching the DECODE_ switches in IRremote.h.  UNKNOWN last
+// gives a hash for any other code; leave it out to ignore other remotes.
+//
+#include <IRremote.h>
+
+int  RECV_PIN = 11;
+
+IRrecvProtocols<NEC, SAMSUNG, RC5, UNKNOWN>  irrecv(RECV_PIN);
+
+decode_results  results;
+
+//+=============================================================================
+void  setup ( )
+{
+  Serial.begin(9600);
+  irrecv.enableIRIn();
+}
+
+//+=============================================================================
+void  loop ( )
+{
+  if (irrecv.decode(&results)) {
+    switch (results.decode_type) {
+      case NEC:      Serial.print("NEC     ");  break ;
+      case SAMSUNG:  Serial.print("SAMSUNG ");  break ;
+      case RC5:      Serial.print("RC5     ");  break ;
+      default:       Serial.print("Other   ");  break ;
+    }
+    Serial.println(results.value, HEX);
+    irrecv.resume();
+  }
+}
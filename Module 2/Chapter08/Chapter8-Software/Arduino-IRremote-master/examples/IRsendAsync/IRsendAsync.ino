@@ -0,0 +1,48 @@
+//------------------------------------------------------------------------------
+// IRsendAsync : Send IR without stopping the sketch
+//
+// sendRaw() holds the CPU for the whole frame, about 70 mS for a Samsung code,
+// and sending it three times 40 mS apart takes a quarter of a second.
+// sendAsync() queues the frame and returns at once; the timer ISR plays it,
+// the copies and the gaps between them while loop() keeps running.
+//
+// An IR LED must be connected to the output PWM pin (3 on an Uno).
+//
+#include <IRremote.h>
+
+IRsend  irsend;
+
+// SAMSUNG E0E0E01F : Mark, space, mark, ... in uS
+const unsigned int  volumeUp[] = {
+  4500,4500, 550,1700, 550,1700, 550,1700, 550,550, 550,550, 550,550, 550,550,
+  550,550, 550,1700, 550,1700, 550,1700, 550,550, 550,550, 550,550, 550,550,
+  550,550, 550,1700, 550,1700, 550,1700, 550,550, 550,550, 550,550, 550,550,
+  550,550, 550,550, 550,550, 550,550, 550,1700, 550,1700, 550,1700, 550,1700,
+  550,1700, 550
+};
+
+unsigned long  last;
+unsigned long  loops;
+
+//+=============================================================================
+void  setup ( )
+{
+  Serial.begin(9600);
+}
+
+//+=============================================================================
+void  loop ( )
+{
+  loops++;
+
+  // Every two seconds : The code, then two more copies 40 mS apart
+  if (millis() - last >= 2000) {
+    last = millis();
+    if (!irsend.sendAsync(volumeUp, sizeof(volumeUp) / sizeof(volumeUp[0]), 38, 2, 40))
+      Serial.println("Queue full");
+
+    Serial.print(loops, DEC);
+    Serial.println(" loops since the last send");
+    loops = 0;
+  }
+}
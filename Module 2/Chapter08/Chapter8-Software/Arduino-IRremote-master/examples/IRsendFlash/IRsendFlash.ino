@@ -0,0 +1,52 @@
+//------------------------------------------------------------------------------
+// IRsendFlash : Remote buttons kept in flash, built by the compiler
+//
+// Each button is a frame of one byte per mark or space, in PROGMEM, so a
+// sketch can hold dozens of them without using any RAM.  IR_FRAME_NEC() and
+// friends work out the marks and spaces of a code at compile time, and
+// IRrawFrame<> packs timings dumped by IRrecvDumpV2.  Sending one is a loop
+// over bytes, with no bit shuffling left to do.
+//
+// Send a digit on the serial monitor to send that button.
+// An IR LED must be connected to the output PWM pin (3 on an Uno).
+//
+#include <IRremote.h>
+
+IRsend  irsend;
+
+const uint8_t  power[]   PROGMEM = { IR_FRAME_NEC(0x20DF10EF) };
+const uint8_t  volUp[]   PROGMEM = { IR_FRAME_NEC(0x20DF40BF) };
+const uint8_t  volDown[] PROGMEM = { IR_FRAME_NEC(0x20DFC03F) };
+const uint8_t  tvPower[] PROGMEM = { IR_FRAME_SAMSUNG(0xE0E040BF) };
+const uint8_t  cdPlay[]  PROGMEM = { IR_FRAME_RC5(0x175, 12) };
+const uint8_t  vcrMute[] PROGMEM = { IR_FRAME_SONY(0x290, 12) };
+
+// A code no protocol macro covers, from raw timings (uS)
+#define AIRCON_ON  IRrawFrame<38, 3500,1750, 450,1300, 450,450, 450,450, 450,1300, 450,450, \
+                                  450,1300, 450,450, 450,450, 450>::frame
+
+const uint8_t * const  buttons[] = { power, volUp, volDown, tvPower, cdPlay, vcrMute, AIRCON_ON };
+
+//+=============================================================================
+void  setup ( )
+{
+  Serial.begin(9600);
+}
+
+//+=============================================================================
+void  loop ( )
+{
+  if (!Serial.available())  return ;
+
+  int  button = Serial.read() - '0';
+  if ((button < 0) || (button >= (int)(sizeof(buttons) / sizeof(buttons[0]))))  return ;
+
+  if (buttons[button] == vcrMute) {
+    // Sony devices want the code three times
+    irsend.sendAsync_P(vcrMute, 2, 30);
+  } else {
+    irsend.sendRaw_P(buttons[button]);
+  }
+  Serial.print("Sent button ");
+  Serial.println(button, DEC);
+}
@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+// IRstats : Why are presses going missing?
+//
+// Decodes as usual and every 10 seconds prints the receiver's counters :
+//   frames the ISR recorded, those cut short or lost for want of a slot,
+//   how often each decoder ran and how often it took the frame, and the
+//   longest timer ISR and decode() so far.
+// A button whose frames are counted but never decoded needs its protocol
+//   looked at; overruns mean loop() is not calling decode() often enough.
+// The longest ISR, in cycles, also compares ways of sampling the detector :
+//   Build it as is, then with IRrecvPin<11> (see IRremote.h).
+//
+#include <IRremote.h>
+
+int  RECV_PIN = 11;
+
+IRrecv          irrecv(RECV_PIN);
+decode_results  results;
+unsigned long   last;
+
+// Names by decode_type + 1
+const char  *names[IR_TYPES] = {
+  "UNKNOWN", "UNUSED", "RC5", "RC6", "NEC", "SONY", "PANASONIC", "JVC",
+  "SAMSUNG", "WHYNTER", "AIWA_RC_T501", "LG", "SANYO", "MITSUBISHI", "DISH",
+  "SHARP", "DENON", "PRONTO", "PULSE_DISTANCE"
+};
+
+//+=============================================================================
+void  setup ( )
+{
+  Serial.begin(9600);
+  irrecv.enableIRIn();
+}
+
+//+=============================================================================
+void  report ( )
+{
+  irstats_t  st;
+
+  irrecv.stats(&st);
+
+  Serial.print("Frames ");       Serial.print(st.frames, DEC);
+  Serial.print(", overflows ");  Serial.print(st.overflows, DEC);
+  Serial.print(", overruns ");   Serial.print(st.overruns, DEC);
+  Serial.print(", echoes ");     Serial.print(st.echoes, DEC);
+  Serial.print(", dropped ");    Serial.println(st.dropped, DEC);
+
+  for (int t = 0;  t < IR_TYPES;  t++) {
+    if (!st.tries[t] && !st.decoded[t])  continue ;
+    Serial.print("  ");
+    Serial.print(names[t]);
+    Serial.print(" : ");
+    Serial.print(st.decoded[t], DEC);
+    Serial.print(" of ");
+    Serial.println(st.tries[t], DEC);
+  }
+
+  Serial.print("Longest ISR ");
+  Serial.print(st.isrmax, DEC);
+  Serial.print(" cycles (");
+  Serial.print(st.isrmax / (F_CPU / 1000000), DEC);
+  Serial.print(" uS), decode() ");
+  Serial.print(st.decodemax, DEC);
+  Serial.println(" uS");
+}
+
+//+=============================================================================
+void  loop ( )
+{
+  if (irrecv.decode(&results)) {
+    Serial.println(results.value, HEX);
+    irrecv.resume();
+  }
+
+  if (millis() - last >= 10000) {
+    last = millis();
+    report();
+  }
+}
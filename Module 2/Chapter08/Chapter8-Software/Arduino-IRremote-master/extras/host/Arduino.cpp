@@ -0,0 +1,51 @@
+//******************************************************************************
+// Host stub of the Arduino core : See Arduino.h
+//******************************************************************************
+
+#include "Arduino.h"
+
+#include <chrono>
+
+HostSerial  Serial;
+
+volatile uint8_t  hostPort = 1;  // Idle : The detector output is active low
+volatile uint8_t  TCCR2A, TCCR2B, OCR2A, OCR2B, TCNT2, TIMSK2;
+volatile uint8_t  DDRB, PORTB;
+
+uint8_t  hostEEPROM[E2END + 1];
+static struct hostEEPROMErase {
+	hostEEPROMErase ( )  { memset(hostEEPROM, 0xFF, sizeof(hostEEPROM)); }
+}  hostEEPROMErased;
+
+static const std::chrono::steady_clock::time_point  hostStart = std::chrono::steady_clock::now();
+
+extern "C" {
+
+void  pinMode      (uint8_t pin,  uint8_t mode)  { }
+int   digitalRead  (uint8_t pin)                 { return HIGH; }
+void  digitalWrite (uint8_t pin,  uint8_t val)   { }
+void  cli          (void)                        { }
+void  sei          (void)                        { }
+
+unsigned long  micros (void)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hostStart).count();
+}
+
+unsigned long  millis (void)
+{
+	return micros() / 1000;
+}
+
+void  delayMicroseconds (unsigned int us)
+{
+	unsigned long  start = micros();
+	while (micros() - start < us) ;
+}
+
+void  delay (unsigned long ms)
+{
+	delayMicroseconds(ms * 1000);
+}
+
+}
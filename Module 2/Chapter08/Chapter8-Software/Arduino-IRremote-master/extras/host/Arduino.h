@@ -0,0 +1,90 @@
+//******************************************************************************
+// Host stub of the Arduino core
+// Just enough of Arduino.h for IRremote to compile and decode on a Linux host.
+// There is no hardware : pins read as idle, the timer registers are plain
+//   variables and nothing is ever interrupted.
+//******************************************************************************
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "avr/pgmspace.h"
+#include "avr/interrupt.h"
+
+typedef bool     boolean;
+typedef uint8_t  byte;
+
+#define HIGH    1
+#define LOW     0
+#define INPUT   0
+#define OUTPUT  1
+
+#define DEC  10
+#define HEX  16
+
+#define _BV(bit)  (1u << (bit))
+
+// Binary constants used by the BLINKLED macros
+#define B00000001    1
+#define B00100000   32
+#define B01111111  127
+#define B10000000  128
+#define B11011111  223
+#define B11111110  254
+
+extern "C" {
+	void           pinMode           (uint8_t pin,  uint8_t mode) ;
+	int            digitalRead       (uint8_t pin) ;
+	void           digitalWrite      (uint8_t pin,  uint8_t val) ;
+	unsigned long  micros            (void) ;
+	unsigned long  millis            (void) ;
+	void           delay             (unsigned long ms) ;
+	void           delayMicroseconds (unsigned int us) ;
+}
+
+// Every pin is bit 0 of one dummy port
+extern volatile uint8_t  hostPort;
+#define digitalPinToPort(pin)      (0)
+#define digitalPinToBitMask(pin)   (1)
+#define portInputRegister(port)    (&hostPort)
+#define portOutputRegister(port)   (&hostPort)
+
+// Serial goes to stdout
+class HostSerial
+{
+	public:
+		void  begin   (long baud)                        { }
+		void  print   (const char *s)                    { fputs(s, stdout); }
+		void  print   (char c)                           { putchar(c); }
+		void  print   (long v,  int base = DEC)          { printf((base == HEX) ? "%lX" : "%ld", v); }
+		void  print   (unsigned long v,  int base = DEC) { printf((base == HEX) ? "%lX" : "%lu", v); }
+		void  print   (int v,  int base = DEC)           { print((long)v, base); }
+		void  print   (unsigned int v,  int base = DEC)  { print((unsigned long)v, base); }
+		void  println (void)                             { putchar('\n'); }
+		template <class T>  void  println (T v)                { print(v);  println(); }
+		template <class T>  void  println (T v,  int base)     { print(v, base);  println(); }
+} ;
+extern HostSerial  Serial;
+
+// 1K of EEPROM, as on an ATmega328P (see avr/eeprom.h)
+#define E2END  0x3FF
+
+// Timer2, as used by the default IR_USE_TIMER2 configuration
+extern volatile uint8_t  TCCR2A, TCCR2B, OCR2A, OCR2B, TCNT2, TIMSK2;
+extern volatile uint8_t  DDRB, PORTB;
+#define WGM20   0
+#define WGM21   1
+#define WGM22   3
+#define CS20    0
+#define CS21    1
+#define CS22    2
+#define COM2B1  5
+#define OCIE2A  1
+
+#endif
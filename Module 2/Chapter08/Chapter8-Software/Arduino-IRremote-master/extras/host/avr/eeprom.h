@@ -0,0 +1,17 @@
+// Host stub of <avr/eeprom.h> : EEPROM is an array, erased (0xFF) at start-up
+#ifndef host_avr_eeprom_h
+#define host_avr_eeprom_h
+
+#include <stdint.h>
+#include <string.h>
+
+extern uint8_t  hostEEPROM[];
+
+#define eeprom_read_byte(p)          (hostEEPROM[(uintptr_t)(p)])
+#define eeprom_update_byte(p, v)     (hostEEPROM[(uintptr_t)(p)] = (uint8_t)(v))
+#define eeprom_read_word(p)          ((uint16_t)(hostEEPROM[(uintptr_t)(p)] | (hostEEPROM[(uintptr_t)(p) + 1] << 8)))
+#define eeprom_update_word(p, v)     (hostEEPROM[(uintptr_t)(p)] = (uint8_t)(v), hostEEPROM[(uintptr_t)(p) + 1] = (uint8_t)((v) >> 8))
+#define eeprom_read_block(d, p, n)   memcpy((d), hostEEPROM + (uintptr_t)(p), (n))
+#define eeprom_update_block(s, p, n) memcpy(hostEEPROM + (uintptr_t)(p), (s), (n))
+
+#endif
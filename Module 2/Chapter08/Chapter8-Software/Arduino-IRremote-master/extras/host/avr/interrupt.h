@@ -0,0 +1,10 @@
+// Host stub of <avr/interrupt.h> : An ISR is an ordinary function
+#ifndef host_avr_interrupt_h
+#define host_avr_interrupt_h
+
+#define ISR(vector, ...)  extern "C" void vector (void)
+
+extern "C" void  cli (void) ;
+extern "C" void  sei (void) ;
+
+#endif
@@ -0,0 +1,22 @@
+// Host stub of <avr/pgmspace.h> : Flash is ordinary memory
+#ifndef host_avr_pgmspace_h
+#define host_avr_pgmspace_h
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P               const char *
+#define pgm_read_byte(p)    (*(const uint8_t *)(p))
+#define pgm_read_word(p)    (*(const uint16_t *)(p))
+#define pgm_read_dword(p)   (host_pgm_read_dword(p))
+#define memcpy_P(d, s, n)   memcpy((d), (s), (n))
+
+static inline  uint32_t  host_pgm_read_dword (const void *p)
+{
+	uint32_t  v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+#endif
@@ -0,0 +1,100 @@
+#include "capture.h"
+#include "IRremoteInt.h"
+
+#include <strings.h>
+
+//+=============================================================================
+// Protocol name, as printed by IRrecvDumpV2
+//
+const char *  protocolName (decode_type_t type)
+{
+	switch (type) {
+		default:
+		case UNKNOWN:      return "UNKNOWN";
+		case NEC:          return "NEC";
+		case SONY:         return "SONY";
+		case RC5:          return "RC5";
+		case RC6:          return "RC6";
+		case DISH:         return "DISH";
+		case SHARP:        return "SHARP";
+		case JVC:          return "JVC";
+		case SANYO:        return "SANYO";
+		case MITSUBISHI:   return "MITSUBISHI";
+		case SAMSUNG:      return "SAMSUNG";
+		case LG:           return "LG";
+		case WHYNTER:      return "WHYNTER";
+		case AIWA_RC_T501: return "AIWA_RC_T501";
+		case PANASONIC:    return "PANASONIC";
+		case DENON:        return "DENON";
+		case PULSE_DISTANCE: return "PULSE_DISTANCE";
+	}
+}
+
+//+=============================================================================
+// True if the line holds a capture rather than a comment or nothing
+//
+bool  isCapture (const std::string &text)
+{
+	size_t  first = text.find_first_not_of(" \t");
+
+	if ((first == std::string::npos) || (text[first] == '#'))  return false ;
+	return text.find_first_of("0123456789") != std::string::npos;
+}
+
+//+=============================================================================
+// Parse one line into 50uS ticks
+// Returns the number of intervals (0 if the line holds no capture)
+//
+int  parseCapture (const std::string &text,  std::vector<unsigned int> &ticks)
+{
+	const char  *p     = text.c_str();
+	const char  *brace = strchr(p, '{');
+
+	ticks.clear();
+	if (!isCapture(text))  return 0 ;
+	if (brace)  p = brace + 1 ;
+
+	while (*p && (*p != '}') && (*p != '/')) {
+		if ((*p >= '0') && (*p <= '9')) {
+			char           *end;
+			unsigned long  usec = strtoul(p, &end, 10);
+			ticks.push_back(usec / USECPERTICK);
+			p = end;
+		} else {
+			p++;
+		}
+	}
+
+	// Drop the LED-off terminator
+	if (!ticks.empty() && !ticks.back())  ticks.pop_back() ;
+
+	return ticks.size();
+}
+
+//+=============================================================================
+// Parse the "// PROTOCOL [ADDRESS:]VALUE" comment after a capture
+//
+expect_t  parseExpect (const std::string &text)
+{
+	expect_t  e = { false, UNKNOWN, 0, 0 };
+	size_t    at = text.find("//");
+	char      name[32];
+	char      code[32] = "";
+
+	if (at == std::string::npos)                                    return e ;
+	if (sscanf(text.c_str() + at + 2, "%31s %31s", name, code) < 1)  return e ;
+
+	for (int t = UNKNOWN;  t <= PULSE_DISTANCE;  t++) {
+		if (!strcasecmp(name, protocolName((decode_type_t)t))) {
+			const char  *colon = strchr(code, ':');
+
+			e.known = true;
+			e.type  = (decode_type_t)t;
+			if (colon)  e.address = strtoul(code, NULL, 16) ;
+			e.value = strtoul(colon ? colon + 1 : code, NULL, 16);
+			break;
+		}
+	}
+
+	return e;
+}
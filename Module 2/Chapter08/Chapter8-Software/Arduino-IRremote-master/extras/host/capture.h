@@ -0,0 +1,34 @@
+//******************************************************************************
+// Reading raw IR captures on a Linux host : shared by irbatch and irbench
+//
+// A capture is one line of text holding intervals in microseconds, as printed
+//   by the IRrecvDumpV2 example:
+//     unsigned int  rawData[69] = {47536, 4700,4250, 750,1500, ... 500,0};  // SAMSUNG E0E0E01F
+//   or just the list of numbers.  The first value is the gap before the code
+//   and a trailing 0 (the LED-off terminator) is ignored.  Lines starting
+//   with # are comments.
+//******************************************************************************
+#ifndef capture_h
+#define capture_h
+
+#include "IRremote.h"
+
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// What a capture should decode to, from the comment after it
+//
+struct expect_t {
+	bool           known;    // false if the line has no comment
+	decode_type_t  type;
+	unsigned long  value;    // Not checked for UNKNOWN
+	unsigned int   address;  // Panasonic only
+};
+
+const char *  protocolName (decode_type_t type) ;
+bool          isCapture    (const std::string &text) ;
+int           parseCapture (const std::string &text,  std::vector<unsigned int> &ticks) ;
+expect_t      parseExpect  (const std::string &text) ;
+
+#endif // capture_h
@@ -0,0 +1,142 @@
+//******************************************************************************
+// irbatch : Decode archived raw IR captures on a Linux host, using every core
+//
+// Each input line holds one capture in microseconds, in the format described
+//   in capture.h.  Lines without a capture are skipped.
+//
+// For every capture one line is written, in input order :
+//     <line number> <protocol> <value in hex> <bits>
+// followed, on stderr, by the number of captures of each protocol.
+//
+// usage: irbatch [-j threads] [file ...]   (reads stdin when no file is given)
+//******************************************************************************
+
+#include "capture.h"
+
+#include <thread>
+#include <vector>
+
+#define BATCH  65536  // Lines read, decoded and written per round
+
+//+=============================================================================
+// One capture and what it decoded to
+//
+struct capture_t {
+	unsigned long   line;
+	std::string     text;
+	int             ok;
+	decode_type_t   type;
+	unsigned long   value;
+	int             bits;
+};
+
+//+=============================================================================
+// Decode captures[first], captures[first + step], ...
+// decode(ticks, n, results) touches no shared state, so one IRrecv serves
+//   every thread
+//
+static void  decodeSome (IRrecv *irrecv,  std::vector<capture_t> *captures,  size_t first,  size_t step)
+{
+	std::vector<unsigned int>  ticks;
+	decode_results             results;
+
+	for (size_t i = first;  i < captures->size();  i += step) {
+		capture_t  &c = (*captures)[i];
+		int        n  = parseCapture(c.text, ticks);
+
+		c.ok = n && irrecv->decode(&ticks[0], n, &results);
+		if (c.ok) {
+			c.type  = results.decode_type;
+			c.value = results.value;
+			c.bits  = results.bits;
+		}
+	}
+}
+
+//+=============================================================================
+// Read, decode and print one round of captures
+// Returns false at the end of the input
+//
+static bool  batch (IRrecv *irrecv,  FILE *in,  unsigned long *line,  unsigned threads,  unsigned long counts[])
+{
+	std::vector<capture_t>  captures;
+	char                    buf[4096];
+	std::string             text;
+
+	// Read up to BATCH captures; a capture may be longer than buf
+	while ((captures.size() < BATCH) && fgets(buf, sizeof(buf), in)) {
+		text += buf;
+		if (text.empty() || (text[text.size() - 1] != '\n'))  continue ;
+
+		(*line)++;
+		if (isCapture(text)) {
+			capture_t  c;
+			c.line = *line;
+			c.text.swap(text);
+			captures.push_back(c);
+		}
+		text.clear();
+	}
+	if (isCapture(text)) {  // Last line without a newline
+		capture_t  c;
+		c.line = ++(*line);
+		c.text.swap(text);
+		captures.push_back(c);
+	}
+	if (captures.empty())  return false ;
+
+	// Decode them across the threads
+	std::vector<std::thread>  workers;
+	for (unsigned t = 1;  t < threads;  t++)
+		workers.push_back(std::thread(decodeSome, irrecv, &captures, t, threads));
+	decodeSome(irrecv, &captures, 0, threads);
+	for (size_t t = 0;  t < workers.size();  t++)  workers[t].join() ;
+
+	// Report them in input order
+	for (size_t i = 0;  i < captures.size();  i++) {
+		capture_t  &c = captures[i];
+		printf("%lu %s %lX %d\n", c.line, c.ok ? protocolName(c.type) : "NONE",
+		       c.ok ? (unsigned long)(uint32_t)c.value : 0UL, c.ok ? c.bits : 0);
+		counts[c.ok ? c.type + 2 : 0]++;
+	}
+
+	return true;
+}
+
+//+=============================================================================
+int  main (int argc,  char *argv[])
+{
+	unsigned       threads = std::thread::hardware_concurrency();
+	int            arg     = 1;
+	IRrecv         irrecv(0);
+	unsigned long  counts[2 + PULSE_DISTANCE + 1] = {0};  // NONE, UNKNOWN, then by decode_type
+
+	if ((argc > 2) && !strcmp(argv[1], "-j")) {
+		threads = atoi(argv[2]);
+		arg     = 3;
+	}
+	if (threads < 1)  threads = 1 ;
+
+	if (arg == argc) {
+		unsigned long  line = 0;
+		while (batch(&irrecv, stdin, &line, threads, counts)) ;
+	}
+	for ( ;  arg < argc;  arg++) {
+		FILE  *in = fopen(argv[arg], "r");
+		if (!in) {
+			perror(argv[arg]);
+			return 1;
+		}
+		unsigned long  line = 0;
+		while (batch(&irrecv, in, &line, threads, counts)) ;
+		fclose(in);
+	}
+
+	// Summary
+	for (int i = 0;  i < 2 + PULSE_DISTANCE + 1;  i++) {
+		if (!counts[i])  continue ;
+		fprintf(stderr, "%-14s %lu\n", i ? protocolName((decode_type_t)(i - 2)) : "NONE", counts[i]);
+	}
+
+	return 0;
+}
@@ -0,0 +1,222 @@
+//******************************************************************************
+// irbench : Decoder throughput, latency and accuracy on a Linux host
+//
+// Replays a corpus of raw captures (corpus.txt by default, format in
+//   capture.h) through IRrecv::decode(), together with copies of each capture
+//   whose every interval has been moved by a random amount of up to the jitter.
+//   Reports :
+//     - decodes per second over the whole set
+//     - per protocol, a histogram of how long each decode took
+//     - per protocol, how many captures decoded to the wrong protocol or value
+//
+// Exits with 1 if any capture of the corpus itself (without jitter) no longer
+//   decodes to what its comment says, so "make bench" fails on a regression.
+//   Misdecoded jittered copies are only reported, never fail the run : 100 uS
+//   is past the tolerance of most protocols' short marks, so their wrong% is
+//   a measure of how much slack each decoder has, not a pass mark.
+//
+// usage: irbench [-v variants] [-j jitter_us] [-r passes] [corpus ...]
+//******************************************************************************
+
+#include "capture.h"
+#include "IRremoteInt.h"
+
+#include <chrono>
+#include <random>
+
+#define VARIANTS  50    // Jittered copies of each capture
+#define JITTER    100   // Largest change to an interval, in uS
+#define PASSES    200   // Times the whole set is decoded
+
+//------------------------------------------------------------------------------
+// Latency histogram : bucket b counts decodes taking under BUCKET0 << b nS
+//
+#define BUCKET0   50
+#define BUCKETS   8
+
+//+=============================================================================
+// One capture to decode, and what it should decode to
+//
+struct sample_t {
+	std::vector<unsigned int>  ticks;
+	expect_t                   expect;
+	bool                       jittered;
+};
+
+//+=============================================================================
+// Results for one (expected) protocol
+//
+struct tally_t {
+	unsigned long  samples;
+	unsigned long  wrongType[2];   // [jittered]
+	unsigned long  wrongValue[2];
+	unsigned long  count[2];
+	unsigned long  hist[BUCKETS + 1];
+	double         totalNs;
+};
+
+//+=============================================================================
+// Load a corpus, adding the jittered copies of each capture
+//
+static bool  load (const char *name,  std::vector<sample_t> &samples,  int variants,  int jitter,  std::mt19937 &rng)
+{
+	FILE                                *in = fopen(name, "r");
+	char                                buf[4096];
+	std::string                         text;
+	std::uniform_int_distribution<int>  move(-jitter, jitter);
+
+	if (!in) {
+		perror(name);
+		return false;
+	}
+
+	while (fgets(buf, sizeof(buf), in)) {
+		text += buf;
+		if (text[text.size() - 1] != '\n')  continue ;
+
+		sample_t  s;
+		if (parseCapture(text, s.ticks)) {
+			s.expect   = parseExpect(text);
+			s.jittered = false;
+			samples.push_back(s);
+
+			// Jittered copies, built from the microseconds again rather than ticks
+			std::vector<unsigned int>  exact = s.ticks;
+			for (int v = 0;  v < variants;  v++) {
+				for (size_t i = 0;  i < exact.size();  i++) {
+					long  usec = (long)exact[i] * USECPERTICK + (USECPERTICK / 2) + move(rng);
+					s.ticks[i] = (usec < 0) ? 0 : usec / USECPERTICK;
+				}
+				s.jittered = true;
+				samples.push_back(s);
+			}
+		}
+		text.clear();
+	}
+
+	fclose(in);
+	return true;
+}
+
+//+=============================================================================
+// True if the decode matches what the capture should decode to
+//
+static bool  sameType (const expect_t &e,  int ok,  const decode_results &r)
+{
+	return ok ? (r.decode_type == e.type) : (e.type == UNKNOWN);
+}
+
+static bool  sameValue (const expect_t &e,  const decode_results &r)
+{
+	if (e.type == UNKNOWN)  return true ;
+	if ((e.type == PANASONIC) && (r.address != e.address))  return false ;
+	return (uint32_t)r.value == (uint32_t)e.value;
+}
+
+//+=============================================================================
+int  main (int argc,  char *argv[])
+{
+	int                    variants = VARIANTS;
+	int                    jitter   = JITTER;
+	int                    passes   = PASSES;
+	int                    arg      = 1;
+	std::vector<sample_t>  samples;
+	std::mt19937           rng(1);  // Fixed seed : the same set every run
+	IRrecv                 irrecv(0);
+	decode_results         results;
+	tally_t                tally[1 + PULSE_DISTANCE + 1] = {};  // UNKNOWN, then by decode_type
+	int                    regressions = 0;
+
+	for ( ;  (arg + 1 < argc) && (argv[arg][0] == '-');  arg += 2) {
+		if      (!strcmp(argv[arg], "-v"))  variants = atoi(argv[arg + 1]) ;
+		else if (!strcmp(argv[arg], "-j"))  jitter   = atoi(argv[arg + 1]) ;
+		else if (!strcmp(argv[arg], "-r"))  passes   = atoi(argv[arg + 1]) ;
+		else                                break ;
+	}
+	if (passes < 1)  passes = 1 ;
+
+	if (arg == argc) {
+		if (!load("corpus.txt", samples, variants, jitter, rng))  return 2 ;
+	}
+	for ( ;  arg < argc;  arg++) {
+		if (!load(argv[arg], samples, variants, jitter, rng))  return 2 ;
+	}
+	if (samples.empty()) {
+		fprintf(stderr, "No captures found\n");
+		return 2;
+	}
+
+	// Throughput : the whole set, untimed decode by decode
+	unsigned long  decodes = 0;
+	auto           start   = std::chrono::steady_clock::now();
+	for (int pass = 0;  pass < passes;  pass++) {
+		for (size_t i = 0;  i < samples.size();  i++) {
+			irrecv.decode(&samples[i].ticks[0], samples[i].ticks.size(), &results);
+			decodes++;
+		}
+	}
+	double  secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// Latency and accuracy, one decode at a time
+	for (size_t i = 0;  i < samples.size();  i++) {
+		sample_t  &s = samples[i];
+		tally_t   &t = tally[s.expect.type + 1];
+		int       ok = 0;
+
+		for (int pass = 0;  pass < passes;  pass++) {
+			auto    t0 = std::chrono::steady_clock::now();
+			ok = irrecv.decode(&s.ticks[0], s.ticks.size(), &results);
+			double  ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+
+			int  b = 0;
+			while ((b < BUCKETS) && (ns >= ((double)BUCKET0 * (1 << b))))  b++ ;
+			t.hist[b]++;
+			t.samples++;
+			t.totalNs += ns;
+		}
+
+		if (!s.expect.known)  continue ;
+		t.count[s.jittered]++;
+		if (!sameType(s.expect, ok, results)) {
+			t.wrongType[s.jittered]++;
+		} else if (!sameValue(s.expect, results)) {
+			t.wrongValue[s.jittered]++;
+		} else {
+			continue;
+		}
+
+		if (!s.jittered) {
+			regressions++;
+			fprintf(stderr, "MISDECODE %s %lX : got %s %lX\n", protocolName(s.expect.type),
+			        (unsigned long)(uint32_t)s.expect.value, ok ? protocolName(results.decode_type) : "NONE",
+			        ok ? (unsigned long)(uint32_t)results.value : 0UL);
+		}
+	}
+
+	// Report
+	printf("%lu captures (%d jittered copies of each, +/-%duS), %d passes\n",
+	       (unsigned long)samples.size(), variants, jitter, passes);
+	printf("Throughput: %.0f decodes/sec (%lu decodes in %.3f s)\n\n", decodes / secs, decodes, secs);
+
+	printf("%-14s %5s %6s %6s  %5s %8s %8s   decode time (nS), %% of decodes\n",
+	       "protocol", "exact", "wrong", "jitter", "wrong", "wrong%", "mean");
+	printf("%-14s %5s %6s %6s  %5s %8s %8s  ", "", "", "", "", "", "", "(nS)");
+	for (int b = 0;  b < BUCKETS;  b++)  printf(" <%-5d", BUCKET0 << b) ;
+	printf(" more\n");
+
+	for (int p = 0;  p < 1 + PULSE_DISTANCE + 1;  p++) {
+		tally_t  &t = tally[p];
+		if (!t.samples)  continue ;
+
+		unsigned long  wrong0 = t.wrongType[0] + t.wrongValue[0];
+		unsigned long  wrong1 = t.wrongType[1] + t.wrongValue[1];  // Reported, not counted as regressions
+		printf("%-14s %5lu %6lu %6lu  %5lu %7.1f%% %8.0f  ", protocolName((decode_type_t)(p - 1)),
+		       t.count[0], wrong0, t.count[1], wrong1, t.count[1] ? 100.0 * wrong1 / t.count[1] : 0.0,
+		       t.totalNs / t.samples);
+		for (int b = 0;  b <= BUCKETS;  b++)  printf(" %5.1f ", 100.0 * t.hist[b] / t.samples) ;
+		printf("\n");
+	}
+
+	if (regressions)  printf("\n%d corpus captures misdecoded\n", regressions) ;
+	return regressions ? 1 : 0;
+}
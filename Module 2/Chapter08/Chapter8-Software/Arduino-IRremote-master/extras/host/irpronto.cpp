@@ -0,0 +1,93 @@
+//******************************************************************************
+// irpronto : Turn Pronto codes into frames for a sketch, before it is built
+//
+// Each input line holds one Pronto code, optionally after a name :
+//     power  0000 006D 0022 0002 0157 00AC 0015 0016 ...
+// Lines starting with # are comments.  For every code a PROGMEM frame is
+//   written to stdout, ready to paste into the sketch and send with
+//   IRsend::sendRaw_P() or sendAsync_P() : The parsing is done here, with the
+//   library's own irProntoParse(), and costs the Arduino nothing.
+//
+// usage: irpronto [-r] [file ...]   (reads stdin when no file is given)
+//   -r  the "repeat" code of each Pronto code, rather than the "once" code
+//******************************************************************************
+
+#include "IRremote.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#define LINEMAX  8192
+
+//+=============================================================================
+// Convert every code in a file; returns false if any of them is not valid
+//
+static bool  convert (FILE *in,  const char *file,  bool repeat)
+{
+	char           text[LINEMAX];
+	uint8_t        frame[2 + 255];
+	uint8_t        gap;
+	unsigned long  line = 0;
+	int            unnamed = 0;
+	bool           ok = true;
+
+	while (fgets(text, sizeof(text), in)) {
+		char  *cp = text;
+		char   name[64];
+
+		line++;
+		while (isspace(*cp))  cp++ ;
+		if (!*cp || (*cp == '#'))  continue ;
+
+		// A leading word which is not 4 hex digits names the code
+		size_t  n = strcspn(cp, " \t\r\n");
+		if ((n != 4) || (strspn(cp, "0123456789ABCDEFabcdef") < 4)) {
+			snprintf(name, sizeof(name), "%.*s", (int)n, cp);
+			cp += n;
+		} else {
+			snprintf(name, sizeof(name), "code%d", ++unnamed);
+		}
+
+		int  len = irProntoParse(cp, frame, sizeof(frame), repeat, PRONTO_FALLBACK, &gap);
+		if (!len) {
+			fprintf(stderr, "%s:%lu: %s is not a Pronto code we can send\n", file, line, name);
+			ok = false;
+			continue;
+		}
+
+		printf("// %s : %d kHz, %d marks and spaces", name, frame[0], frame[1]);
+		if (gap)  printf(", then %d mS of lead-out : Use it as the gap of sendAsync_P()", gap) ;
+		printf("\nconst uint8_t  %s[] PROGMEM = {", name);
+		for (int i = 0;  i < len;  i++)  printf("%s%s%d", i ? "," : "", (i && !(i % 20)) ? "\n\t" : " ", frame[i]) ;
+		printf(" };\n");
+	}
+
+	return ok;
+}
+
+//+=============================================================================
+int  main (int argc,  char *argv[])
+{
+	bool  repeat = false;
+	bool  ok     = true;
+	int   arg    = 1;
+
+	if ((argc > 1) && !strcmp(argv[1], "-r")) {
+		repeat = true;
+		arg    = 2;
+	}
+
+	if (arg == argc)  ok = convert(stdin, "stdin", repeat) ;
+	for ( ;  arg < argc;  arg++) {
+		FILE  *in = fopen(argv[arg], "r");
+		if (!in) {
+			perror(argv[arg]);
+			return 1;
+		}
+		ok &= convert(in, argv[arg], repeat);
+		fclose(in);
+	}
+
+	return ok ? 0 : 1;
+}
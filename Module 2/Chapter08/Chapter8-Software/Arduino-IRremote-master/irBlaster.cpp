@@ -0,0 +1,247 @@
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+//==============================================================================
+//              BBBB   L        AAA    SSSS  TTTTT  EEEEE  RRRR
+//              B   B  L       A   A  S        T    E      R   R
+//              BBBB   L       AAAAA   SSS     T    EEE    RRRR
+//              B   B  L       A   A      S    T    E      R  R
+//              BBBB   LLLLL   A   A  SSSS     T    EEEEE  R   R
+//==============================================================================
+// IRsend has one emitter, on the library's own timer, so it sends one frame
+//   at a time.  The blaster drives one more emitter from each spare 16 bit
+//   timer, and they all send at once : Each timer makes its emitter's carrier,
+//   at the frame's own kHz, and the library's timer ISR switches it on and off
+//   at the tick the frame says (irBlastStep).  While one emitter waits out the
+//   gap after a copy, the others carry on, so four NEC codes for four devices
+//   take the time of one.
+//
+// Frames are those of IRsend::sendRaw_P() and sendFrame() : IR_FRAME_...,
+//   IRrawFrame and irProntoParse() all build them, in ticks of USECPERTICK,
+//   which is the rate the ISR runs at.
+//
+// Timers 1, 3, 4 and 5 have the same registers and bits, so the Timer1 bit
+//   names serve them all.
+//
+#if IR_BLAST_CHANNELS
+
+typedef
+	struct {
+		volatile uint8_t   *tccra;
+		volatile uint8_t   *tccrb;
+		volatile uint16_t  *icr;
+		volatile uint16_t  *ocra;
+		uint8_t             pin;    // OCnA
+	}
+irblasttimer_t;
+
+static const irblasttimer_t  irBlastTimers[IR_BLAST_CHANNELS] PROGMEM = {
+#if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+#	if !defined(IR_USE_TIMER1)
+	{ &TCCR1A, &TCCR1B, &ICR1, &OCR1A, 11 },
+#	endif
+#	if !defined(IR_USE_TIMER3)
+	{ &TCCR3A, &TCCR3B, &ICR3, &OCR3A,  5 },
+#	endif
+#	if !defined(IR_USE_TIMER4)
+	{ &TCCR4A, &TCCR4B, &ICR4, &OCR4A,  6 },
+#	endif
+#	if !defined(IR_USE_TIMER5)
+	{ &TCCR5A, &TCCR5B, &ICR5, &OCR5A, 46 },
+#	endif
+#else
+	{ &TCCR1A, &TCCR1B, &ICR1, &OCR1A,  9 },
+#endif
+};
+
+static uint8_t  irBlastLED;  // Bit n : Emitter n is in a mark
+
+//+=============================================================================
+// Start the oldest frame waiting for an emitter : Its carrier, then its first
+//   interval on the next tick
+// Returns false if none is waiting.  Called with interrupts disabled.
+//
+static bool  irBlastTake (uint8_t channel)
+{
+	volatile irblast_t  *ch = &irblast[channel];
+	irblasttimer_t       t;
+	uint8_t              q;
+
+	for (q = 0;  (q < irblastcount) && (irblastq[q].channel != channel);  q++) ;
+	if (q == irblastcount)  return false ;
+
+	const uint8_t  *frame   = irblastq[q].frame;
+	uint8_t         progmem = irblastq[q].progmem;
+	ch->repeats = irblastq[q].repeats;
+	ch->gap     = irblastq[q].gap;
+	for (irblastcount--;  q < irblastcount;  q++) {
+		irblastq[q].frame   = irblastq[q + 1].frame;
+		irblastq[q].channel = irblastq[q + 1].channel;
+		irblastq[q].progmem = irblastq[q + 1].progmem;
+		irblastq[q].repeats = irblastq[q + 1].repeats;
+		irblastq[q].gap     = irblastq[q + 1].gap;
+	}
+
+	// Phase and frequency correct PWM with ICRn as top, as TIMER_CONFIG_KHZ()
+	//   does for IR_USE_TIMER1; the pin stays off until a mark
+	memcpy_P(&t, &irBlastTimers[channel], sizeof(t));
+	const uint16_t  pwmval = SYSCLOCK / 2000 / (progmem ? pgm_read_byte(frame) : frame[0]);
+	*t.tccra = _BV(WGM11);
+	*t.tccrb = _BV(WGM13) | _BV(CS10);
+	*t.icr   = pwmval;
+	*t.ocra  = pwmval / 3;
+
+	ch->tccra   = t.tccra;
+	ch->ticks   = frame + 2;
+	ch->progmem = progmem;
+	ch->len     = progmem ? pgm_read_byte(frame + 1) : frame[1] ;
+	ch->i       = 0;
+	ch->left    = 1;
+	return true;
+}
+
+//+=============================================================================
+// The interval an emitter was in has ended : Start its next one
+// Called by irBlastStep() from the timer ISR
+//
+void  irBlastNext (uint8_t channel)
+{
+	volatile irblast_t  *ch  = &irblast[channel];
+	uint8_t              bit = 1 << channel;
+
+	for (;;) {
+		// Next mark or space; one of 0 leaves the LED as it is
+		while (ch->i < ch->len) {
+			uint8_t  ticks = ch->progmem ? pgm_read_byte(ch->ticks + ch->i) : ch->ticks[ch->i] ;
+			if (ticks) {
+				if (ch->i & 1) {
+					*ch->tccra &= ~_BV(COM1A1);
+					irBlastLED &= ~bit;
+				} else {
+					*ch->tccra |= _BV(COM1A1);
+					irBlastLED |= bit;
+					irtxled     = 1;
+				}
+				if (!irBlastLED && irtxled) {
+					irtxled = 0;
+					irtxoff = micros();
+				}
+				ch->left = ticks;
+				ch->i++;
+				return;
+			}
+			ch->i++;
+		}
+
+		// End of a copy : LED off for the gap
+		if (ch->i == ch->len) {
+			*ch->tccra &= ~_BV(COM1A1);
+			irBlastLED &= ~bit;
+			if (!irBlastLED && irtxled) {
+				irtxled = 0;
+				irtxoff = micros();
+			}
+			ch->i++;
+			if (ch->gap) {
+				ch->left = ch->gap * (1000 / USECPERTICK);
+				return;
+			}
+		}
+
+		// Gap over : The next copy, else the next frame for this emitter
+		if (ch->repeats) {
+			ch->repeats--;
+			ch->i = 0;
+		} else if (irBlastTake(channel)) {
+			return;
+		} else {
+			irblastbusy &= ~bit;
+			if (!irblastbusy && !irTimerReceivers())  TIMER_DISABLE_INTR ;  // Nothing left for the ISR
+			return;
+		}
+	}
+}
+
+//+=============================================================================
+// The pin an emitter is on
+//
+uint8_t  IRblaster::pin (uint8_t channel)
+{
+	return (channel < IR_BLAST_CHANNELS) ? pgm_read_byte(&irBlastTimers[channel].pin) : 0 ;
+}
+
+//+=============================================================================
+// Send a frame in RAM on one emitter, 'repeats' more times after the first
+//   copy, with 'gap' mS of silence after each copy.  The frame must stay as it
+//   is until sending(channel) returns false.
+// Returns at once : The frame goes out as soon as the emitter has sent those
+//   queued on it before.
+// Returns false, and sends nothing, for a channel this board does not have,
+//   a frame with no carrier, while IRsend::sendAsync() frames are going out
+//   (they have the timer), or if IR_BLASTER frames are already waiting
+//
+bool  IRblaster::send (uint8_t channel,  const uint8_t *frame,  uint8_t repeats,  uint8_t gap)
+{
+	return queue(channel, frame, false, repeats, gap);
+}
+
+//+=============================================================================
+// As above, for a frame in PROGMEM
+//
+bool  IRblaster::send_P (uint8_t channel,  const uint8_t *frame,  uint8_t repeats,  uint8_t gap)
+{
+	return queue(channel, frame, true, repeats, gap);
+}
+
+//+=============================================================================
+bool  IRblaster::queue (uint8_t channel,  const uint8_t *frame,  bool progmem,  uint8_t repeats,  uint8_t gap)
+{
+	if (channel >= IR_BLAST_CHANNELS)                        return false ;
+	if (!(progmem ? pgm_read_byte(frame) : frame[0]))        return false ;  // 0 kHz
+
+	cli();
+#if IR_SEND_QUEUE
+	if (irsendcount) {  // The timer is running the carrier for sendAsync()
+		sei();
+		return false;
+	}
+#endif
+	if (irblastcount == IR_BLASTER) {
+		sei();
+		return false;
+	}
+	irblastq[irblastcount].frame   = frame;
+	irblastq[irblastcount].channel = channel;
+	irblastq[irblastcount].progmem = progmem;
+	irblastq[irblastcount].repeats = repeats;
+	irblastq[irblastcount].gap     = gap;
+	irblastcount++;
+
+	if (!(irblastbusy & (1 << channel))) {
+		// Idle emitter : Start it now
+		if (!irblastbusy && (irtxtimer || !irTimerReceivers()))  irRecvResume() ;  // Get the ISR ticking
+		pinMode(pgm_read_byte(&irBlastTimers[channel].pin), OUTPUT);
+		irBlastTake(channel);
+		irblastbusy |= 1 << channel;
+	}
+	sei();
+	return true;
+}
+
+//+=============================================================================
+// Is a frame still going out, or waiting to, on any emitter?
+//
+bool  IRblaster::sending ( )
+{
+	return irblastbusy != 0;
+}
+
+//+=============================================================================
+// As above, on one emitter
+//
+bool  IRblaster::sending (uint8_t channel)
+{
+	return (irblastbusy & (1 << channel)) != 0;
+}
+
+#endif // IR_BLAST_CHANNELS
@@ -0,0 +1,156 @@
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+//+=============================================================================
+// The codec engine : One send loop and one decode loop for every protocol
+//   which sends each bit as a mark and a space, driven by its ircodec_t.
+// A protocol file only has to describe its timing, eg. ir_NEC.cpp; a sketch
+//   can describe one of its own the same way and call sendCodec() with it.
+//
+
+//+=============================================================================
+static inline  bool  irIn (unsigned int ticks,  const irrange_t &r)
+{
+	return (ticks >= r.lo) && (ticks <= r.hi);
+}
+
+//+=============================================================================
+// Send a code of 'nbits' bits from data[], first bit in the MSB of data[0]
+// With 'repeat' send the protocol's repeat instead : Its repeat pair if it
+//   has one (NEC), else the code without the header if IR_CODEC_RPT_BARE (JVC)
+//
+void  IRsend::sendCodec (const ircodec_t *codec,  const uint8_t *data,  int nbits,  bool repeat)
+{
+	ircodec_t  c;
+
+	memcpy_P(&c, codec, sizeof(c));
+
+	// Set IR carrier frequency
+	enableIROut(c.khz);
+
+	if (repeat && c.rpt.mark) {
+		mark (c.rpt.mark);
+		space(c.rpt.space);
+
+	} else {
+		// Header
+		if (c.lead.mark) {
+			mark (c.lead.mark);
+			space(c.lead.space);
+		}
+		if (c.hdr.mark && !(repeat && (c.flags & IR_CODEC_RPT_BARE))) {
+			mark (c.hdr.mark);
+			space(c.hdr.space);
+		}
+
+		// Data
+		for (int i = 0;  i < nbits;  i++) {
+			const irpair_t  *bit = (data[i >> 3] & (0x80 >> (i & 7))) ? &c.one : &c.zero ;
+			mark (bit->mark);
+			space(bit->space);
+		}
+	}
+
+	// Footer
+	if (c.stop.mark)  mark(c.stop.mark) ;
+	space(c.stop.space);  // Always end with the LED off
+}
+
+//+=============================================================================
+// As above, for a code of up to 32 bits in the low bits of 'data'
+//
+void  IRsend::sendCodec (const ircodec_t *codec,  unsigned long data,  int nbits,  bool repeat)
+{
+	uint8_t   bytes[4];
+	uint32_t  word = data;  // 32 bits wherever long is longer
+
+	// First bit to the top, as in decode_results.data[]
+	if ((nbits > 0) && (nbits < 32))  word <<= 32 - nbits ;
+	for (int i = 0;  i < 4;  i++, word <<= 8)  bytes[i] = word >> 24 ;
+
+	sendCodec(codec, bytes, nbits, repeat);
+}
+
+//+=============================================================================
+static bool  irCodecRepeat (decode_results *results,  int8_t type)
+{
+	results->bits        = 0;
+	results->value       = REPEAT;
+	results->decode_type = (decode_type_t)type;
+	return true;
+}
+
+//+=============================================================================
+// Decode a frame sent with the descriptor's timing
+// A header whose space is longer than _GAP ends a frame of its own (DISH), so
+//   then the frame starts at the first bit.  The space of the last bit is only
+//   known once a mark ends it : The stop mark, or without one, the header of
+//   the next copy of the code.
+// results->value gets the last 32 bits; longer codes also fill data[]
+//
+bool  IRrecv::decodeCodec (decode_results *results,  const ircodec_t *codec)
+{
+	ircodec_t         c;
+	uint32_t          data   = 0;  // The last 32 bits, as on AVR
+	int               offset = 1;  // Skip the gap
+	int               len    = results->rawlen;
+	bool              hdr;
+	const irrange_t  *last;
+	int               need;
+
+	memcpy_P(&c, codec, sizeof(c));
+
+	// Repeat : The repeat pair and the stop mark
+	if (c.rpt.mark && (len == 4)
+	    && irIn(results->rawbuf[1], c.rpt.marks)
+	    && irIn(results->rawbuf[2], c.rpt.spaces)
+	    && irIn(results->rawbuf[3], c.stop.marks)) {
+		return irCodecRepeat(results, c.type);
+	}
+
+	// Repeat : The code without its header
+	if ((c.flags & IR_CODEC_RPT_BARE) && (len == (2 * c.bits) + 2)
+	    && irIn(results->rawbuf[1], c.one.marks)
+	    && irIn(results->rawbuf[len - 1], c.stop.marks)) {
+		return irCodecRepeat(results, c.type);
+	}
+
+	// Check we have the right amount of data
+	hdr  = c.hdr.mark && (c.hdr.space <= _GAP);
+	last = c.stop.mark ? &c.stop.marks : &c.hdr.marks ;
+	need = 1 + (c.lead.mark ? 2 : 0) + (hdr ? 2 : 0) + (2 * c.bits) + 1;
+	if ((c.flags & IR_CODEC_EXACT) ? (len != need) : (len < need))  return false ;
+
+	// Header
+	if (c.lead.mark) {
+		if (!irIn(results->rawbuf[offset++], c.lead.marks ))  return false ;
+		if (!irIn(results->rawbuf[offset++], c.lead.spaces))  return false ;
+	}
+	if (hdr) {
+		if (!irIn(results->rawbuf[offset++], c.hdr.marks ))  return false ;
+		if (!irIn(results->rawbuf[offset++], c.hdr.spaces))  return false ;
+	}
+
+	// Data
+	for (int i = 0;  i < c.bits;  i++) {
+		unsigned int  m = results->rawbuf[offset++];
+		unsigned int  s = results->rawbuf[offset++];
+		uint8_t       bit;
+
+		if      (irIn(m, c.one.marks ) && irIn(s, c.one.spaces ))  bit = 1 ;
+		else if (irIn(m, c.zero.marks) && irIn(s, c.zero.spaces))  bit = 0 ;
+		else                                                       return false ;
+
+		data = (data << 1) | bit;
+		if (c.bits > 32)  irDataBit(results, i, bit) ;
+	}
+
+	// Footer
+	if (!irIn(results->rawbuf[offset], *last))  return false ;
+
+	// Success
+	results->bits        = c.bits;
+	results->value       = data;
+	results->decode_type = (decode_type_t)c.type;
+	return true;
+}
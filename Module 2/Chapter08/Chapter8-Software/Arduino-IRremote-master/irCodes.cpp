@@ -0,0 +1,173 @@
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+#ifdef E2END
+#	include <avr/eeprom.h>
+#endif
+
+//+=============================================================================
+// The key a decoded code is kept under (its action is left alone)
+//
+static void  irCodeKey (decode_results *results,  ircode_t *key)
+{
+	key->value       = results->value;
+	key->address     = (results->decode_type == PANASONIC) ? results->address : 0 ;
+	key->decode_type = results->decode_type;
+}
+
+//+=============================================================================
+// Table order : By value, then by decode_type, then by address
+// Returns <0, 0 or >0 as the entry sorts before, with or after the key
+//
+static int  irCodeOrder (const ircode_t *code,  const ircode_t *key)
+{
+	if (code->value       != key->value)        return (code->value < key->value) ? -1 : 1 ;
+	if (code->decode_type != key->decode_type)  return (code->decode_type < key->decode_type) ? -1 : 1 ;
+	if (code->address     != key->address)      return (code->address < key->address) ? -1 : 1 ;
+	return 0;
+}
+
+//+=============================================================================
+// Binary search for a code
+// Returns its index if *found, otherwise the index it would be inserted at
+//
+unsigned int  IRcodes::find (const ircode_t *key,  bool *found)
+{
+	unsigned int  lo = 0;
+	unsigned int  hi = entries;
+	ircode_t      code;
+
+	while (lo < hi) {
+		unsigned int  mid   = lo + ((hi - lo) / 2);
+		read(mid, &code);
+		int           order = irCodeOrder(&code, key);
+
+		if      (order < 0)  lo = mid + 1 ;
+		else if (order > 0)  hi = mid ;
+		else {
+			*found = true;
+			return mid;
+		}
+	}
+
+	*found = false;
+	return lo;
+}
+
+//+=============================================================================
+// The action for a decoded code, or IR_NO_ACTION if it is not in the table
+//
+int  IRcodes::lookup (decode_results *results)
+{
+	ircode_t      code;
+	bool          found;
+
+	irCodeKey(results, &code);
+	unsigned int  i = find(&code, &found);
+	if (!found)  return IR_NO_ACTION ;
+
+	read(i, &code);
+	return code.action;
+}
+
+//+=============================================================================
+// Check the table is in the order lookup() relies on (and has no duplicates)
+//
+bool  IRcodes::sorted ( )
+{
+	ircode_t  prev;
+	ircode_t  code;
+
+	for (unsigned int i = 1;  i < entries;  i++) {
+		read(i - 1, &prev);
+		read(i,     &code);
+		if (irCodeOrder(&prev, &code) >= 0)  return false ;
+	}
+	return true;
+}
+
+//+=============================================================================
+void  IRcodesPROGMEM::read (unsigned int i,  ircode_t *code)
+{
+	memcpy_P(code, table + i, sizeof(*code));
+}
+
+#ifdef E2END
+//+=============================================================================
+// EEPROM layout from 'base' : The number of entries (2 bytes), then the entries
+// Erased EEPROM reads as 0xFFFF entries, which is taken as an empty table
+//
+IRcodesEEPROM::IRcodesEEPROM (int base,  unsigned int capacity)
+	: IRcodes(0), base(base), capacity(capacity)
+{
+	entries = eeprom_read_word((const uint16_t *)(uintptr_t)base);
+	if (entries > capacity)  entries = 0 ;
+}
+
+void  IRcodesEEPROM::read (unsigned int i,  ircode_t *code)
+{
+	eeprom_read_block(code, (const void *)(uintptr_t)(base + 2 + (i * sizeof(*code))), sizeof(*code));
+}
+
+void  IRcodesEEPROM::write (unsigned int i,  const ircode_t *code)
+{
+	eeprom_update_block(code, (void *)(uintptr_t)(base + 2 + (i * sizeof(*code))), sizeof(*code));
+}
+
+//+=============================================================================
+// Map a code to an action, replacing whatever it was mapped to before
+// Later entries are moved up one to keep the order, so learning is slower the
+//   bigger the table, but lookup() stays a binary search
+//
+bool  IRcodesEEPROM::learn (decode_results *results,  uint8_t action)
+{
+	ircode_t      key;
+	ircode_t      code;
+	bool          found;
+
+	irCodeKey(results, &key);
+	unsigned int  at = find(&key, &found);
+	if (!found) {
+		if (entries >= capacity)  return false ;
+
+		for (unsigned int i = entries;  i > at;  i--) {
+			read(i - 1, &code);
+			write(i, &code);
+		}
+		entries++;
+		eeprom_update_word((uint16_t *)(uintptr_t)base, entries);
+	}
+
+	key.action = action;
+	write(at, &key);
+
+	return true;
+}
+
+//+=============================================================================
+bool  IRcodesEEPROM::forget (decode_results *results)
+{
+	ircode_t      code;
+	bool          found;
+
+	irCodeKey(results, &code);
+	unsigned int  at = find(&code, &found);
+	if (!found)  return false ;
+
+	for (unsigned int i = at + 1;  i < entries;  i++) {
+		read(i, &code);
+		write(i - 1, &code);
+	}
+	entries--;
+	eeprom_update_word((uint16_t *)(uintptr_t)base, entries);
+
+	return true;
+}
+
+//+=============================================================================
+void  IRcodesEEPROM::clear ( )
+{
+	entries = 0;
+	eeprom_update_word((uint16_t *)(uintptr_t)base, entries);
+}
+#endif
@@ -6,83 +6,164 @@
 //+=============================================================================
 // Interrupt Service Routine - Fires every 50uS
 // TIMER2 interrupt code to collect raw data.
-// Widths of alternating SPACE, MARK are recorded in rawbuf.
-// Recorded in ticks of 50uS [microseconds, 0.000050 seconds]
-// 'rawlen' counts the number of entries recorded so far.
-// First entry is the SPACE between transmissions.
-// As soon as a the first [SPACE] entry gets long:
-//   Ready is set; State switches to IDLE; Timing of SPACE continues.
-// As soon as first MARK arrives:
-//   Gap width is recorded; Ready is cleared; New logging starts
+// The state machine itself is irTimerTick() in IRremoteInt.h
+// While IRsend::sendAsync() has frames going out, the timer runs the carrier
+//   instead, and the ISR plays them (irSendStep)
+// It also times the marks and spaces of IRblaster's emitters (irBlastStep)
 //
+#if !IR_SKETCH_ISR
 ISR (TIMER_INTR_NAME)
 {
 	TIMER_RESET;
 
+#if IR_SEND_QUEUE
+	if (irSendStep())  return ;
+#endif
+	IR_BLAST_STEP();
+
 	// Read if IR Receiver -> SPACE [xmt LED off] or a MARK [xmt LED on]
-	// digitalRead() is very slow. Optimisation is possible, but makes the code unportable
-	uint8_t  irdata = (uint8_t)digitalRead(irparams.recvpin);
-
-	irparams.timer++;  // One more 50uS tick
-	if (irparams.rawlen >= RAWBUF)  irparams.rcvstate = STATE_OVERFLOW ;  // Buffer overflow
-
-	switch(irparams.rcvstate) {
-		//......................................................................
-		case STATE_IDLE: // In the middle of a gap
-			if (irdata == MARK) {
-				if (irparams.timer < GAP_TICKS)  {  // Not big enough to be a gap.
-					irparams.timer = 0;
-
-				} else {
-					// Gap just ended; Record duration; Start recording transmission
-					irparams.overflow                  = false;
-					irparams.rawlen                    = 0;
-					irparams.rawbuf[irparams.rawlen++] = irparams.timer;
-					irparams.timer                     = 0;
-					irparams.rcvstate                  = STATE_MARK;
-				}
-			}
-			break;
-		//......................................................................
-		case STATE_MARK:  // Timing Mark
-			if (irdata == SPACE) {   // Mark ended; Record time
-				irparams.rawbuf[irparams.rawlen++] = irparams.timer;
-				irparams.timer                     = 0;
-				irparams.rcvstate                  = STATE_SPACE;
-			}
-			break;
-		//......................................................................
-		case STATE_SPACE:  // Timing Space
-			if (irdata == MARK) {  // Space just ended; Record time
-				irparams.rawbuf[irparams.rawlen++] = irparams.timer;
-				irparams.timer                     = 0;
-				irparams.rcvstate                  = STATE_MARK;
-
-			} else if (irparams.timer > GAP_TICKS) {  // Space
-					// A long Space, indicates gap between codes
-					// Flag the current code as ready for processing
-					// Switch to STOP
-					// Don't reset timer; keep counting Space width
-					irparams.rcvstate = STATE_STOP;
+#if IR_RECEIVERS > 1
+	irTimerTickAll();
+#else
+	if (IR_TIMER_RECEIVING(&irparams))  irTimerTick(&irparams, irRecvLevel()) ;
+#endif
+
+	IR_ISR_TIMED();
+}
+#endif
+
+//+=============================================================================
+// Edge-triggered capture - Fires on every change of the detector output
+// Attached to the receive pin by IRrecv::enableIRIn(IR_CAPTURE_EDGE), so the
+//   CPU is only interrupted while there is IR traffic, rather than every 50uS.
+// The state machine itself is irEdgeTick() in IRremoteInt.h
+//
+void  irEdgeISR ( )
+{
+	irEdgeTick(&irparams, irRecvLevel());
+}
+
+#if IR_EARLY_END
+//+=============================================================================
+// Early end of frame : The headers of the protocols whose frames have a fixed
+//   length, and those lengths (see irend_t and irEndLookup)
+//
+#if DECODE_NEC
+	extern const irend_t  irEndNEC,  irEndNECRepeat;
+#endif
+#if DECODE_SAMSUNG
+	extern const irend_t  irEndSAMSUNG,  irEndSAMSUNGRepeat;
+#endif
+#if DECODE_LG
+	extern const irend_t  irEndLG;
+#endif
+#if DECODE_JVC
+	extern const irend_t  irEndJVC;
+#endif
+#if DECODE_PANASONIC
+	extern const irend_t  irEndPanasonic;
+#endif
+
+const irend_t * const  irEnds[] = {
+#if DECODE_NEC
+	&irEndNEC,  &irEndNECRepeat,
+#endif
+#if DECODE_SAMSUNG
+	&irEndSAMSUNG,  &irEndSAMSUNGRepeat,
+#endif
+#if DECODE_LG
+	&irEndLG,
+#endif
+#if DECODE_JVC
+	&irEndJVC,
+#endif
+#if DECODE_PANASONIC
+	&irEndPanasonic,
+#endif
+	0
+};
+#endif
+
+#if IR_STREAM
+//+=============================================================================
+// Streaming decode - Called by the ISR each time an interval is recorded
+// Follows a code through its header and bits using the timing tables of the
+//   pulse-distance protocols below, so the value is ready for decode() as soon
+//   as the space after the last bit ends.  Anything unexpected simply stops
+//   the stream; decode() then decodes the frame from the buffer as usual.
+//
+#if DECODE_NEC
+	extern const irstream_t  irStreamNEC;
+#endif
+#if DECODE_SAMSUNG
+	extern const irstream_t  irStreamSAMSUNG;
+#endif
+
+static const irstream_t * const  irStreams[] = {
+#if DECODE_NEC
+	&irStreamNEC,
+#endif
+#if DECODE_SAMSUNG
+	&irStreamSAMSUNG,
+#endif
+};
+
+#define IR_IN_RANGE(t, r)  (((t) >= (r).lo) && ((t) <= (r).hi))
+
+static void  irStreamDone (volatile irparams_t *ir,  const irstream_t *p,  unsigned long value,  uint8_t bits)
+{
+	ir->stream      = 0;
+	ir->streamtype  = p->type;
+	ir->streamvalue = value;
+	ir->streambits  = bits;
+	ir->streamlen   = ir->rawlen;
+	ir->streamready = IR_STREAM_READY;
+}
+
+void  irStreamStep (volatile irparams_t *ir)
+{
+	irlen_t            idx = ir->rawlen - 1;
+	unsigned int       t   = ir->rawbuf[idx];
+	const irstream_t  *p;
+
+	// Gap : A new frame has started
+	if (idx == 0) {
+		ir->stream = 0;
+		return;
+	}
+
+	// Header mark : Pick the protocol to follow
+	if (idx == 1) {
+		for (uint8_t i = 0;  i < sizeof(irStreams) / sizeof(irStreams[0]);  i++) {
+			p = irStreams[i];
+			if (IR_IN_RANGE(t, p->hdrmark)) {
+				ir->stream      = i + 1;
+				ir->streamvalue = 0;
+				return;
 			}
-			break;
-		//......................................................................
-		case STATE_STOP:  // Waiting; Measuring Gap
-		 	if (irdata == MARK)  irparams.timer = 0 ;  // Reset gap timer
-		 	break;
-		//......................................................................
-		case STATE_OVERFLOW:  // Flag up a read overflow; Stop the State Machine
-			irparams.overflow = true;
-			irparams.rcvstate = STATE_STOP;
-		 	break;
+		}
+		return;
 	}
 
-	// If requested, flash LED while receiving IR data
-	if (irparams.blinkflag) {
-		if (irdata == MARK)  
-			if (irparams.blinkpin) digitalWrite(irparams.blinkpin, HIGH); // Turn user defined pin LED on
-				else BLINKLED_ON() ;   // if no user defined LED pin, turn default LED pin for the hardware on
-		else if (irparams.blinkpin) digitalWrite(irparams.blinkpin, LOW); // Turn user defined pin LED on
-				else BLINKLED_OFF() ;   // if no user defined LED pin, turn default LED pin for the hardware on
+	if (!ir->stream)  return ;
+	p = irStreams[ir->stream - 1];
+
+	if (idx == 2) {  // Header space : Code or repeat
+		if      (IR_IN_RANGE(t, p->hdrspace) && (ir->framegap[ir->framehead] >= p->mingap))  return ;
+		else if (IR_IN_RANGE(t, p->rptspace))  ir->streamvalue = REPEAT ;
+		else                                   ir->stream      = 0 ;
+
+	} else if (idx & 1) {  // Bit mark
+		if      (!IR_IN_RANGE(t, p->bitmark))                      ir->stream = 0 ;
+		else if ((idx == 3) && (ir->streamvalue == REPEAT))  irStreamDone(ir, p, REPEAT, 0) ;
+
+	} else {  // Bit space
+		if      (IR_IN_RANGE(t, p->onespace))   ir->streamvalue = (ir->streamvalue << 1) | 1 ;
+		else if (IR_IN_RANGE(t, p->zerospace))  ir->streamvalue = (ir->streamvalue << 1) | 0 ;
+		else                                    ir->stream = 0 ;
+
+		if (ir->stream && (idx == 2 + (2 * p->bits)))
+			irStreamDone(ir, p, ir->streamvalue, p->bits);
 	}
 }
+#endif
@@ -0,0 +1,117 @@
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+//+=============================================================================
+// The bit which RC5 and RC6 remotes flip on each new press of a button
+// The rest of the code stays the same while the button is held
+//
+static unsigned long  irToggleMask (const decode_results *results)
+{
+	switch (results->decode_type) {
+		case RC5:  return (results->bits >= 1) ? (1UL << (results->bits - 1)) : 0 ;  // First bit after the start bits
+		case RC6:  return (results->bits >= 4) ? (1UL << (results->bits - 4)) : 0 ;  // The double width T bit
+		default:   return 0;
+	}
+}
+
+//+=============================================================================
+IRkeys::IRkeys (IRrecv *irrecv)
+	: irrecv(irrecv), down(false), pending(false), type(UNKNOWN), value(0), bits(0), toggle(0),
+	  downms(0), lastms(0), nextms(0), repeats(0), nframes(0), framems(0)
+{
+}
+
+//+=============================================================================
+// True if the last frame is the held key, sent again because it is still held
+//
+bool  IRkeys::sameKey (unsigned long mask)
+{
+	return (results.decode_type == type) && (results.bits == bits)
+	    && ((results.value & ~mask) == value) && ((results.value & mask) == toggle);
+}
+
+//+=============================================================================
+bool  IRkeys::report (irkey_t *key,  uint8_t event,  unsigned long now)
+{
+	key->event       = event;
+	key->decode_type = type;
+	key->value       = value;
+	key->bits        = bits;
+	key->time        = now;
+	key->held        = now - downms;
+	key->repeats     = repeats;
+	return true;
+}
+
+//+=============================================================================
+// Decode at most one frame, then report at most one event :
+//   IR_KEY_DOWN   A frame of a new key
+//   IR_KEY_REPEAT Every IR_KEY_RATE mS, once the key has been down IR_KEY_DELAY mS
+//   IR_KEY_UP     IR_KEY_RELEASE mS after its last frame, or a frame of another key
+// Frames which only say the key is still held (NEC repeats, RC5/RC6 with the
+//   same toggle bit, any code sent again) are never reported themselves
+//
+bool  IRkeys::event (irkey_t *key)
+{
+	unsigned long  now = millis();
+
+	// The key which let the last one go : It is in results
+	if (pending) {
+		pending = false;
+	} else if (irrecv->decode(&results)) {
+		unsigned long  mask = irToggleMask(&results);
+
+		irrecv->resume();
+
+		if ((results.decode_type == NEC) && (results.value == REPEAT)) {
+			if (!down)  return false ;  // Repeat of a press we missed
+
+		} else if (down && (results.decode_type == UNKNOWN) && (type != UNKNOWN)) {
+			return false;  // Most likely a garbled frame of the held key
+
+		} else if (down && !sameKey(mask)) {
+			// Another key : Let the held one go first
+			down    = false;
+			pending = true;
+			return report(key, IR_KEY_UP, now);
+		}
+
+		if (down) {  // Still held
+			unsigned long  ms = now - lastms;
+			framems = framems ? (unsigned int)(((3UL * framems) + ms) / 4) : ms ;
+			lastms  = now;
+			nframes++;
+		}
+	} else if (down) {
+		// No frame : Let go, or time to repeat
+		if (now - lastms > IR_KEY_RELEASE) {
+			down = false;
+			return report(key, IR_KEY_UP, now);
+		}
+		if ((long)(now - nextms) >= 0) {
+			nextms = ((long)(now - nextms) < IR_KEY_RATE) ? (nextms + IR_KEY_RATE) : (now + IR_KEY_RATE);
+			repeats++;
+			return report(key, IR_KEY_REPEAT, now);
+		}
+		return false;
+	} else {
+		return false;
+	}
+
+	if (down)  return false ;
+
+	// A new key
+	unsigned long  mask = irToggleMask(&results);
+
+	down    = true;
+	type    = results.decode_type;
+	value   = results.value & ~mask;
+	bits    = results.bits;
+	toggle  = results.value & mask;
+	downms  = now;
+	lastms  = now;
+	nextms  = now + IR_KEY_DELAY;
+	repeats = 0;
+	nframes = 1;
+	return report(key, IR_KEY_DOWN, now);
+}
@@ -1,513 +1,152 @@
-#define TEST 0
-
-#if TEST
-#	define SEND_PRONTO        1
-#	define PRONTO_ONCE        false
-#	define PRONTO_REPEAT      true
-#	define PRONTO_FALLBACK    true
-#	define PRONTO_NOFALLBACK  false
-#endif
-
-#if SEND_PRONTO
-
-//******************************************************************************
-#if TEST
-#	include <stdio.h>
-	void  enableIROut (int freq)  { printf("\nFreq = %d KHz\n", freq); }
-	void  mark        (int t)     { printf("+%d," , t); }
-	void  space       (int t)     { printf("-%d, ", t); }
-#else
-#	include "IRremote.h"
-#endif // TEST
-
-//+=============================================================================
-// Check for a valid hex digit
-//
-bool  ishex (char ch)
-{
-	return ( ((ch >= '0') && (ch <= '9')) ||
-             ((ch >= 'A') && (ch <= 'F')) ||
-             ((ch >= 'a') && (ch <= 'f'))   ) ? true : false ;
-}
-
-//+=============================================================================
-// Check for a valid "blank" ... '\0' is a valid "blank"
-//
-bool  isblank (char ch)
-{
-	return ((ch == ' ') || (ch == '\t') || (ch == '\0')) ? true : false ;
-}
-
-//+=============================================================================
-// Bypass spaces
-//
-bool  byp (char** pcp)
-{
-	while (isblank(**pcp))  (*pcp)++ ;
-}
-
-//+=============================================================================
-// Hex-to-Byte : Decode a hex digit
-// We assume the character has already been validated
-//
-uint8_t  htob (char ch)
-{
-	if ((ch >= '0') && (ch <= '9'))  return ch - '0' ;
-	if ((ch >= 'A') && (ch <= 'F'))  return ch - 'A' + 10 ;
-	if ((ch >= 'a') && (ch <= 'f'))  return ch - 'a' + 10 ;
-}
-
-//+=============================================================================
-// Hex-to-Word : Decode a block of 4 hex digits
-// We assume the string has already been validated
-//   and the pointer being passed points at the start of a block of 4 hex digits
-//
-uint16_t  htow (char* cp)
-{
-	return ( (htob(cp[0]) << 12) | (htob(cp[1]) <<  8) |
-             (htob(cp[2]) <<  4) | (htob(cp[3])      )  ) ;
-}
-
-//+=============================================================================
-//
-bool sendPronto (char* s,  bool repeat,  bool fallback)
-{
-	int       i;
-	int       len;
-	int       skip;
-	char*     cp;
-	uint16_t  freq;  // Frequency in KHz
-	uint8_t   usec;  // pronto uSec/tick
-	uint8_t   once;
-	uint8_t   rpt;
-
-	// Validate the string
-	for (cp = s;  *cp;  cp += 4) {
-		byp(&cp);
-		if ( !ishex(cp[0]) || !ishex(cp[1]) ||
-		     !ishex(cp[2]) || !ishex(cp[3]) || !isblank(cp[4]) )  return false ;
-	}
-
-	// We will use cp to traverse the string
-	cp = s;
-
-	// Check mode = Oscillated/Learned
-	byp(&cp);
-	if (htow(cp) != 0000)  return false;
-	cp += 4;
-
-	// Extract & set frequency
-	byp(&cp);
-	freq = (int)(1000000 / (htow(cp) * 0.241246));  // Rounding errors will occur, tolerance is +/- 10%
-	usec = (int)(((1.0 / freq) * 1000000) + 0.5);  // Another rounding error, thank Cod for analogue electronics
-	freq /= 1000;  // This will introduce a(nother) rounding error which we do not want in the usec calcualtion
-	cp += 4;
-
-	// Get length of "once" code
-	byp(&cp);
-	once = htow(cp);
-	cp += 4;
-
-	// Get length of "repeat" code
-	byp(&cp);
-	rpt = htow(cp);
-	cp += 4;
-
-	// Which code are we sending?
-	if (fallback) { // fallback on the "other" code if "this" code is not present
-		if (!repeat) { // requested 'once'
-			if (once)  len = once * 2,  skip = 0 ;  // if once exists send it
-			else       len = rpt  * 2,  skip = 0 ;  // else send repeat code
-		} else { // requested 'repeat'
-			if (rpt)   len = rpt  * 2,  skip = 0 ;  // if rpt exists send it
-			else       len = once * 2,  skip = 0 ;  // else send once code
-		}
-	} else {  // Send what we asked for, do not fallback if the code is empty!
-		if (!repeat)  len = once * 2,  skip = 0 ;     // 'once' starts at 0
-		else          len = rpt  * 2,  skip = once ;  // 'repeat' starts where 'once' ends
-    }
-
-	// Skip to start of code
-	for (i = 0;  i < skip;  i++, cp += 4)  byp(&cp) ;
-
-	// Send code
-	enableIROut(freq);
-	for (i = 0;  i < len;  i++) {
-		byp(&cp);
-		if (i & 1)  space(htow(cp) * usec);
-		else        mark (htow(cp) * usec);
-		cp += 4;
-	}
-}
-
-//+=============================================================================
-#if TEST
-
-int  main ( )
-{
-	char  prontoTest[] =
-		"0000 0070 0000 0032 0080 0040 0010 0010 0010 0030 " //  10
-		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  20
-		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  30
-		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  40
-		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  50
-		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  60
-		"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  70
-		"0010 0010 0010 0030 0010 0010 0010 0030 0010 0010 " //  80
-		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " //  90
-		"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " // 100
-		"0010 0030 0010 0aa6";                               // 104
-
-	sendPronto(prontoTest, PRONTO_ONCE,   PRONTO_FALLBACK);    // once code
-	sendPronto(prontoTest, PRONTO_REPEAT, PRONTO_FALLBACK);    // repeat code
-	sendPronto(prontoTest, PRONTO_ONCE,   PRONTO_NOFALLBACK);  // once code
-	sendPronto(prontoTest, PRONTO_REPEAT, PRONTO_NOFALLBACK);  // repeat code
-
-	return 0;
-}
-
-#endif // TEST
-
-#endif // SEND_PRONTO
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-#if 0
-//******************************************************************************
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+//==============================================================================
+//                      PPPP   RRRR    OOO   N   N  TTTTT   OOO
+//                      P   P  R   R  O   O  NN  N    T    O   O
+//                      PPPP   RRRR   O   O  N N N    T    O   O
+//                      P      R  R   O   O  N  NN    T    O   O
+//                      P      R   R   OOO   N   N    T     OOO
+//==============================================================================
 // Sources:
 //   http://www.remotecentral.com/features/irdisp2.htm
 //   http://www.hifi-remote.com/wiki/index.php?title=Working_With_Pronto_Hex
-//******************************************************************************
-
-#include <stdint.h>
-#include <stdio.h>
-
-#define IRPRONTO
-#include "IRremoteInt.h"  // The Arduino IRremote library defines USECPERTICK
-
-//------------------------------------------------------------------------------
-// Source: https://www.google.co.uk/search?q=DENON+MASTER+IR+Hex+Command+Sheet
-//         -> http://assets.denon.com/documentmaster/us/denon%20master%20ir%20hex.xls
-//
-char  prontoTest[] =
-	"0000 0070 0000 0032 0080 0040 0010 0010 0010 0030 " //  10
-	"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  20
-	"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  30
-	"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  40
-	"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  50
-	"0010 0010 0010 0030 0010 0010 0010 0010 0010 0010 " //  60
-	"0010 0010 0010 0010 0010 0010 0010 0010 0010 0010 " //  70
-	"0010 0010 0010 0030 0010 0010 0010 0030 0010 0010 " //  80
-	"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " //  90
-	"0010 0010 0010 0030 0010 0010 0010 0010 0010 0030 " // 100
-	"0010 0030 0010 0aa6";                               // 104
-
-//------------------------------------------------------------------------------
-// This is the longest code we can support
-#define CODEMAX  200
-
-//------------------------------------------------------------------------------
-// This is the data we pull out of the pronto code
-typedef
-	struct {
-		int        freq;           // Carrier frequency (in Hz)
-		int        usec;           // uSec per tick (based on freq)
-
-		int        codeLen;        // Length of code
-		uint16_t   code[CODEMAX];  // Code in hex
-
-		int        onceLen;        // Length of "once" transmit
-		uint16_t*  once;           // Pointer to start within 'code'
-
-		int        rptLen;         // Length of "repeat" transmit
-		uint16_t*  rpt;            // Pointer to start within 'code'
-	}
-pronto_t;
-
-//------------------------------------------------------------------------------
-// From what I have seen, the only time we go over 8-bits is the 'space'
-// on the end which creates the lead-out/inter-code gap.  Assuming I'm right,
-// we can code this up as a special case and otherwise halve the size of our
-// data!
-// Ignoring the first four values (the config data) and the last value
-// (the lead-out), if you find a protocol that uses values greater than 00fe
-// we are going to have to revisit this code!
-//
-//
-// So, the 0th byte will be the carrier frequency in Khz (NOT Hz)
-//      "  1st  "    "   "   "  length of the "once" code
-//      "  2nd  "    "   "   "  length of the "repeat" code
-//
-// Thereafter, odd  bytes will be Mark  lengths as a multiple of USECPERTICK uS
-//             even   "     "  "  Space    "    "  "    "     "       "      "
-//
-// Any occurence of "FF" in either a Mark or a Space will indicate
-//   "Use the 16-bit FF value" which will also be a multiple of USECPERTICK uS
-//
-//
-// As a point of comparison, the test code (prontoTest[]) is 520 bytes
-// (yes, more than 0.5KB of our Arduino's precious 32KB) ... after conversion
-// to pronto hex that goes down to ((520/5)*2) = 208 bytes ... once converted to
-// our format we are down to ((208/2) -1 -1 +2) = 104 bytes
-//
-// In fariness this is still very memory-hungry
-// ...As a rough guide:
-//   10 codes cost 1K of memory (this will vary depending on the protocol).
-//
-// So if you're building a complex remote control, you will probably need to
-// keep the codes on an external memory device (not in the Arduino sketch) and
-// load them as you need them.  Hmmm.
 //
-// This dictates that "Oscillated Pronto Codes" are probably NOT the way forward
+// A Pronto code is blocks of 4 hex digits :
+//   0000          Learned (modulated) code; the only form we take
+//   FFFF          Carrier period, in units of 0.241246 uS
+//   ONCE RPT      Number of mark/space pairs in the "once" and "repeat" codes
+//   then the pairs of the "once" code followed by those of the "repeat" code,
+//   each in carrier periods.
 //
-// For example, prontoTest[] happens to be: A 48-bit IR code in Denon format
-// So we know it starts with 80/40                           (Denon header)
-//             and ends with 10/aa6                          (Denon leadout)
-//             and all (48) bits in between are either 10/10 (Denon 0)
-//                                                  or 10/30 (Denon 1)
-// So we could easily store this data in 1-byte  ("Denon")
-//                                     + 1-byte  (Length=48)
-//                                     + 6-bytes (IR code)
-// At 8-bytes per code, we can store 128 codes in 1KB or memory - that's a lot
-// better than the 2 (two) we started off with!
+// irProntoParse() turns one into a frame (see IRremote.h) : Done once, in
+//   setup() or by extras/host/irpronto before the sketch is even built, and
+//   sending it is then a plain loop over bytes.
 //
-// And serendipitously, by reducing the amount of data, our program will run
-// a LOT faster!
-//
-// Again, I repeat, even after you have spent time converting the "Oscillated
-// Pronto Codes" in to IRremote format, it will be a LOT more memory-hungry
-// than using sendDenon() (or whichever) ...BUT these codes are easily
-// available on the internet, so we'll support them!
-//
-typedef
-	struct {
-		uint16_t   FF;
-		uint8_t    code[CODEMAX];
-	}
-irCode_t;
-
-//------------------------------------------------------------------------------
-#define DEBUGF(...)  printf(__VA_ARGS__)
-
-//+=============================================================================
-// String must be block of 4 hex digits separated with blanks
-//
-bool  validate (char* cp,  int* len)
-{
-	for (*len = 0;  *cp;  (*len)++, cp += 4) {
-		byp(&cp);
-		if ( !ishex(cp[0]) || !ishex(cp[1]) ||
-		     !ishex(cp[2]) || !ishex(cp[3]) || !isblank(cp[4]) )  return false ;
-	}
-
-	return true;
-}
+#if SEND_PRONTO
 
 //+=============================================================================
-// Hex-to-Byte : Decode a hex digit
-// We assume the character has already been validated
+// Value of a hex digit, -1 if it is not one
 //
-uint8_t  htob (char ch)
+static int8_t  irProntoHex (char ch)
 {
 	if ((ch >= '0') && (ch <= '9'))  return ch - '0' ;
 	if ((ch >= 'A') && (ch <= 'F'))  return ch - 'A' + 10 ;
 	if ((ch >= 'a') && (ch <= 'f'))  return ch - 'a' + 10 ;
+	return -1;
 }
 
 //+=============================================================================
-// Hex-to-Word : Decode a block of 4 hex digits
-// We assume the string has already been validated
-//   and the pointer being passed points at the start of a block of 4 hex digits
-//
-uint16_t  htow (char* cp)
-{
-	return ( (htob(cp[0]) << 12) | (htob(cp[1]) <<  8) |
-             (htob(cp[2]) <<  4) | (htob(cp[3])      )  ) ;
-}
-
-//+=============================================================================
-// Convert the pronto string in to data
+// Read the next block of 4 hex digits, and step *cp past it
+// Returns 1 with a word, 0 at the end of the string, -1 on anything else
 //
-bool  decode (char* s,  pronto_t* p,  irCode_t* ir)
+static int8_t  irProntoWord (const char **cp,  uint16_t *word)
 {
-	int    i, len;
-	char*  cp;
+	const char  *s = *cp;
 
-	// Validate the Pronto string
-	if (!validate(s, &p->codeLen)) {
-		DEBUGF("Invalid pronto string\n");
-		return false ;
-    }
-	DEBUGF("Found %d hex codes\n", p->codeLen);
+	while ((*s == ' ') || (*s == '\t') || (*s == '\r') || (*s == '\n'))  s++ ;
+	if (!*s)  return 0 ;
 
-	// Allocate memory to store the decoded string
-	//if (!(p->code = malloc(p->len))) {
-	//	DEBUGF("Memory allocation failed\n");
-	//	return false ;
-	//}
-
-	// Check in case our code is too long
-	if (p->codeLen > CODEMAX) {
-		DEBUGF("Code too long, edit CODEMAX and recompile\n");
-		return false ;
-	}
-
-	// Decode the string
-	cp = s;
-	for (i = 0;  i < p->codeLen;  i++, cp += 4) {
-		byp(&cp);
-		p->code[i] = htow(cp);
+	*word = 0;
+	for (uint8_t i = 0;  i < 4;  i++, s++) {
+		int8_t  digit = irProntoHex(*s);
+		if (digit < 0)  return -1 ;
+		*word = (*word << 4) | digit;
 	}
+	if (*s && (*s != ' ') && (*s != '\t') && (*s != '\r') && (*s != '\n'))  return -1 ;
 
-	// Announce our findings
-	DEBUGF("Input: |%s|\n", s);
-	DEBUGF("Found: |");
-    for (i = 0;  i < p->codeLen;  i++)  DEBUGF("%04x ", p->code[i]) ;
-	DEBUGF("|\n");
-
-	DEBUGF("Form [%04X] : ", p->code[0]);
-	if      (p->code[0] == 0x0000)  DEBUGF("Oscillated (Learned)\n");
-	else if (p->code[0] == 0x0100)  DEBUGF("Unmodulated\n");
-	else                            DEBUGF("Unknown\n");
-    if (p->code[0] != 0x0000)  return false ;  // Can only handle Oscillated
-
-	// Calculate the carrier frequency (+/- 10%) & uSecs per pulse
-	// Pronto uses a crystal which generates a timeabse of 0.241246
-	p->freq     = (int)(1000000 / (p->code[1] * 0.241246));
-	p->usec     = (int)(((1.0 / p->freq) * 1000000) + 0.5);
-	ir->code[0] = p->freq / 1000;
-    DEBUGF("Freq [%04X] : %d Hz  (%d uS/pluse) -> %d KHz\n",
-	       p->code[1], p->freq, p->usec, ir->code[0]);
-
-	// Set the length & start pointer for the "once" code
-	p->onceLen  = p->code[2];
-	p->once     = &p->code[4];
-	ir->code[1] = p->onceLen;
-	DEBUGF("Once [%04X] : %d\n", p->code[2], p->onceLen);
-
-	// Set the length & start pointer for the "repeat" code
-	p->rptLen = p->code[3];
-	p->rpt    = &p->code[4 + p->onceLen];
-	ir->code[2] = p->rptLen;
-	DEBUGF("Rpt  [%04X] : %d\n", p->code[3], p->rptLen);
-
-	// Check everything tallies
-	if (1 + 1 + 1 + 1 + (p->onceLen * 2) + (p->rptLen * 2) != p->codeLen) {
-		DEBUGF("Bad code length\n");
-		return false;
-	}
-
-	// Convert the IR data to our new format
-	ir->FF = p->code[p->codeLen - 1];
-
-	len = (p->onceLen * 2) + (p->rptLen * 2);
-	DEBUGF("Encoded: |");
-	for (i = 0;  i < len;  i++) {
-		if (p->code[i+4] == ir->FF) {
-			ir->code[i+3] = 0xFF;
-		} else if (p->code[i+4] > 0xFE) {
-			DEBUGF("\n%04X : Mark/Space overflow\n", p->code[i+4]);
-			return false;
-		} else {
-			ir->code[i+3] = (p->code[i+4] * p->usec) / USECPERTICK;
-		}
-		DEBUGF("%s%d", !i ? "" : (i&1 ? "," : ", "), ir->code[i+3]);
-	}
-	DEBUGF("|\n");
-
-	ir->FF = (ir->FF * p->usec) / USECPERTICK;
-	DEBUGF("FF -> %d\n", ir->FF);
-
-	return true;
+	*cp = s;
+	return 1;
 }
 
 //+=============================================================================
-//
-void  irDump (irCode_t* ir)
+// Parse a Pronto code into frame[] : The carrier (kHz), the number of
+//   intervals, then the intervals in ticks, as built by IR_FRAME_... and
+//   played by IRsend::sendFrame(), sendAsync() or, from flash, sendRaw_P().
+// 'repeat' and 'fallback' pick the "once" or "repeat" code as for sendPronto().
+// A frame holds intervals of up to 255 ticks (12.75 mS) : A longer one is
+//   split into 255, 0, 255, ... as a 0 leaves the LED as it is.  If 'gap' is
+//   given, the lead-out space is cut to 255 ticks instead, and 'gap' gets the
+//   rest of it in mS, to pass on as the gap of sendAsync().
+// Returns the bytes used, or 0 if the code is not valid Pronto, has a carrier
+//   over 255kHz, or does not fit in 'size' bytes (nor in 255 intervals).
+// Integer arithmetic only, in one pass over the string.
+//
+int  irProntoParse (const char *pronto,  uint8_t *frame,  int size,  bool repeat,  bool fallback,
+                    uint8_t *gap)
 {
-	int  i, len;
-
-	printf("uint8_t  buttonName[%d] = {", len);
-
-	printf("%d,%d, ", (ir->FF >> 8), ir->FF & 0xFF);
-	printf("%d,%d,%d, ", ir->code[0], ir->code[1], ir->code[2]);
+	const char     *cp = pronto;
+	uint16_t        hdr[4];
+	uint16_t        word;
+	unsigned long   period;    // Carrier period, in 1/256 uS
+	unsigned long   usec = 0;
+	unsigned long   ticks;
+	unsigned int    skip, len, n;
+	unsigned int    out = 0;   // Intervals written to frame[]
+	int8_t          got;
+
+	for (uint8_t i = 0;  i < 4;  i++)  if (irProntoWord(&cp, &hdr[i]) != 1)  return 0 ;
+
+	// Learned codes, with a carrier a frame can hold (4kHz to 244kHz)
+	if ((hdr[0] != 0x0000) || (hdr[1] < 17) || (hdr[1] > 1024))  return 0 ;
+	period = (hdr[1] * 61759UL) / 1000;  // 0.241246 * 256
 
-	len = (ir->code[1] * 2) + (ir->code[2] * 2);
-	for (i = 0;  i < len;  i++) {
-		printf("%s%d", !i ? "" : (i&1 ? "," : ", "), ir->code[i+3]);
+	// Which code are we sending?
+	if (fallback) {  // fallback on the "other" code if "this" code is not present
+		if ((repeat && hdr[3]) || (!repeat && !hdr[2]))  skip = hdr[2] * 2,  len = hdr[3] * 2 ;
+		else                                             skip = 0,            len = hdr[2] * 2 ;
+	} else {  // Send what we asked for, do not fallback if the code is empty!
+		if (repeat)  skip = hdr[2] * 2,  len = hdr[3] * 2 ;  // 'repeat' starts where 'once' ends
+		else         skip = 0,           len = hdr[2] * 2 ;  // 'once' starts at 0
 	}
+	if (size < 2)  return 0 ;
+
+	frame[0] = (256000UL + (period / 2)) / period;
+
+	for (n = 0;  (got = irProntoWord(&cp, &word)) == 1;  n++) {
+		if ((n < skip) || (n >= skip + len))  continue ;
+		usec  = ((word * period) + 128) >> 8;
+		ticks = (usec + (USECPERTICK / 2)) / USECPERTICK;
+		if (gap && (n == skip + len - 1) && (ticks > 255))  ticks = 255 ;  // Lead-out : The rest goes in *gap
+
+		// 255 ticks at a time, with a 0 between to leave the LED as it is
+		for ( ; ; ) {
+			if ((out > 255) || (2 + (int)out >= size))  return 0 ;
+			frame[2 + out++] = (ticks > 255) ? 255 : ticks ;
+			if (ticks <= 255)  break ;
+			ticks -= 255;
+			if ((out > 255) || (2 + (int)out >= size))  return 0 ;
+			frame[2 + out++] = 0;
+		}
+	}
+	if ((got < 0) || (n != 2 * (hdr[2] + hdr[3])) || (out > 255))  return 0 ;
+	frame[1] = out;
 
-	printf("};\n");
+	// usec is still the last interval : the lead-out space
+	if (gap) {
+		usec  = (usec > 255UL * USECPERTICK) ? usec - (255UL * USECPERTICK) : 0 ;
+		*gap  = (usec > 255000UL) ? 255 : (usec + 500) / 1000 ;
+	}
 
+	return 2 + out;
 }
 
 //+=============================================================================
+// Parse and send a Pronto code, waiting out its lead-out space as well
+// This parses the string on every call : Where that matters, parse it once
+//   with irProntoParse() and send the frame with sendFrame()
+// Returns false if the code is not valid Pronto, or longer than PRONTO_MAX
 //
-int  main ( )
+bool  IRsend::sendPronto (const char *code,  bool repeat,  bool fallback)
 {
-	pronto_t  pCode;
-	irCode_t  irCode;
-
-	decode(prontoTest, &pCode, &irCode);
+	uint8_t  frame[2 + PRONTO_MAX];
+	uint8_t  gap;
 
-	irDump(&irCode);
+	if (!irProntoParse(code, frame, sizeof(frame), repeat, fallback, &gap))  return false ;
 
-	return 0;
+	sendFrame(frame);
+	if (gap)  custom_delay_usec(gap * 1000UL) ;
+	return true;
 }
 
-#endif //0
+#endif // SEND_PRONTO
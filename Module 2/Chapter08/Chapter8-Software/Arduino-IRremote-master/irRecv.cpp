@@ -1,117 +1,772 @@
 #include "IRremote.h"
 #include "IRremoteInt.h"
 
+#ifdef E2END
+#	include <avr/eeprom.h>
+#endif
+
 //+=============================================================================
-// Decodes the received IR message
-// Returns 0 if no data ready, 1 if data ready.
-// Results of decoding are stored in results
+// In IR_CAPTURE_EDGE mode there is no interrupt while the line is idle,
+// so the gap which marks the end of a transmission has to be spotted here.
+// This does the job of the STATE_SPACE -> irFrameDone() step in the timer ISR.
 //
-int  IRrecv::decode (decode_results *results)
+static void  irEdgeGap (volatile irparams_t *ir)
 {
-	results->rawbuf   = irparams.rawbuf;
-	results->rawlen   = irparams.rawlen;
+	if ((ir->capture != IR_CAPTURE_EDGE) || (ir->rcvstate != STATE_SPACE))  return ;
 
-	results->overflow = irparams.overflow;
+	cli();
+	unsigned long  quiet = micros() - ir->lastedge;
+	if ((ir->rcvstate == STATE_SPACE) && ((quiet > _GAP) || IR_ENDED(ir, quiet / USECPERTICK)))
+		irFrameDone(ir);
+	sei();
+}
 
-	if (irparams.rcvstate != STATE_STOP)  return false ;
+//+=============================================================================
+// Empty the frame queue and start recording into the first slot
+// Call with interrupts disabled
+//
+static void  irFramesReset (volatile irparams_t *ir)
+{
+	ir->framehead = 0;
+	ir->frametail = 0;
+	ir->frames    = 0;
+	ir->overruns  = 0;
+#if IR_STREAM
+	ir->stream      = 0;
+	ir->streamready = 0;
+	ir->streamout   = false;
+#endif
+	ir->rawbuf    = ir->rawframes[0];
+	ir->rawlen    = 0;
+	ir->rcvstate  = STATE_IDLE;
+}
 
+//+=============================================================================
+// Header windows of each decoder, defined alongside it in ir_*.cpp
+//
+#if DECODE_RC5
+	extern const irwindow_t  irWindowsRC5[];
+#endif
+#if DECODE_RC6
+	extern const irwindow_t  irWindowsRC6[];
+#endif
 #if DECODE_NEC
-	DBG_PRINTLN("Attempting NEC decode");
-	if (decodeNEC(results))  return true ;
+	extern const irwindow_t  irWindowsNEC[];
 #endif
-
 #if DECODE_SONY
-	DBG_PRINTLN("Attempting Sony decode");
-	if (decodeSony(results))  return true ;
+	extern const irwindow_t  irWindowsSony[];
+#endif
+#if DECODE_PANASONIC
+	extern const irwindow_t  irWindowsPanasonic[];
+#endif
+#if DECODE_JVC
+	extern const irwindow_t  irWindowsJVC[];
+#endif
+#if DECODE_SAMSUNG
+	extern const irwindow_t  irWindowsSAMSUNG[];
+#endif
+#if DECODE_WHYNTER
+	extern const irwindow_t  irWindowsWhynter[];
+#endif
+#if DECODE_AIWA_RC_T501
+	extern const irwindow_t  irWindowsAiwaRCT501[];
+#endif
+#if DECODE_LG
+	extern const irwindow_t  irWindowsLG[];
 #endif
-
 #if DECODE_SANYO
-	DBG_PRINTLN("Attempting Sanyo decode");
-	if (decodeSanyo(results))  return true ;
+	extern const irwindow_t  irWindowsSanyo[];
 #endif
-
 #if DECODE_MITSUBISHI
-	DBG_PRINTLN("Attempting Mitsubishi decode");
-	if (decodeMitsubishi(results))  return true ;
+	extern const irwindow_t  irWindowsMitsubishi[];
+#endif
+#if DECODE_DENON
+	extern const irwindow_t  irWindowsDenon[];
+#endif
+#if DECODE_DISH
+	extern const irwindow_t  irWindowsDISH[];
+#endif
+#if DECODE_SHARP
+	extern const irwindow_t  irWindowsSharp[];
 #endif
 
+//+=============================================================================
+// Could a decoder accept this frame?  True if the gap or header mark falls in
+//   one of its windows (see irwindow_t)
+//
+static bool  irCandidate (const irwindow_t *w,  unsigned int gap,  unsigned int hdr)
+{
+	for (;  w->index != 0xFF;  w++) {
+		unsigned int  t = w->index ? hdr : gap;
+		if ((t >= w->lo) && (t <= w->hi))  return true ;
+	}
+	return false;
+}
+
+//+=============================================================================
+// The decoders decodeFrame() picks from, in the order it starts with
+// Where two decoders can take the same frame, the first one gets it; so with
+//   IR_ADAPT_ORDER neither may pass the other :
+//   Sony and Sanyo take any frame after a short gap as a repeat, so they are
+//     pinned, with DISH (which sends its copies close together) ahead of them
+//   JVC also takes LG codes, and Sharp takes Denon and Mitsubishi ones
+//
+#define IR_BIT(type)  (1UL << ((type) + 1))
+
+const IRrecv::irdecoder_t  IRrecv::decoderTable[] PROGMEM = {
+#if DECODE_NEC
+	{ NEC,           0,  0,                                   irWindowsNEC,         &IRrecv::decodeNEC        },
+#endif
+#if DECODE_DISH
+	{ DISH,          0,  0,                                   irWindowsDISH,        &IRrecv::decodeDish       },
+#endif
+#if DECODE_SONY
+	{ SONY,          1,  0,                                   irWindowsSony,        &IRrecv::decodeSony       },
+#endif
+#if DECODE_SANYO
+	{ SANYO,         1,  0,                                   irWindowsSanyo,       &IRrecv::decodeSanyo      },
+#endif
+#if DECODE_MITSUBISHI
+	{ MITSUBISHI,    0,  0,                                   irWindowsMitsubishi,  &IRrecv::decodeMitsubishi },
+#endif
 #if DECODE_RC5
-	DBG_PRINTLN("Attempting RC5 decode");
-	if (decodeRC5(results))  return true ;
+	{ RC5,           0,  0,                                   irWindowsRC5,         &IRrecv::decodeRC5        },
 #endif
-
 #if DECODE_RC6
-	DBG_PRINTLN("Attempting RC6 decode");
-	if (decodeRC6(results))  return true ;
+	{ RC6,           0,  0,                                   irWindowsRC6,         &IRrecv::decodeRC6        },
 #endif
-
 #if DECODE_PANASONIC
-	DBG_PRINTLN("Attempting Panasonic decode");
-	if (decodePanasonic(results))  return true ;
+	{ PANASONIC,     0,  0,                                   irWindowsPanasonic,   &IRrecv::decodePanasonic  },
 #endif
-
 #if DECODE_LG
-	DBG_PRINTLN("Attempting LG decode");
-	if (decodeLG(results))  return true ;
+	{ LG,            0,  0,                                   irWindowsLG,          &IRrecv::decodeLG         },
 #endif
-
 #if DECODE_JVC
-	DBG_PRINTLN("Attempting JVC decode");
-	if (decodeJVC(results))  return true ;
+	{ JVC,           0,  IR_BIT(LG),                          irWindowsJVC,         &IRrecv::decodeJVC        },
+#endif
+#if DECODE_SAMSUNG
+	{ SAMSUNG,       0,  0,                                   irWindowsSAMSUNG,     &IRrecv::decodeSAMSUNG    },
+#endif
+#if DECODE_WHYNTER
+	{ WHYNTER,       0,  0,                                   irWindowsWhynter,     &IRrecv::decodeWhynter    },
+#endif
+#if DECODE_AIWA_RC_T501
+	{ AIWA_RC_T501,  0,  0,                                   irWindowsAiwaRCT501,  &IRrecv::decodeAiwaRCT501 },
+#endif
+#if DECODE_DENON
+	{ DENON,         0,  0,                                   irWindowsDenon,       &IRrecv::decodeDenon      },
+#endif
+#if DECODE_SHARP
+	{ SHARP,         0,  IR_BIT(DENON) | IR_BIT(MITSUBISHI),  irWindowsSharp,       &IRrecv::decodeSharp      },
 #endif
+};
 
+#if IR_ADAPT_LAG
+//+=============================================================================
+// Receiver lag : The learned lag is applied to each frame before decoding and
+//   refined from each frame which decodes to a protocol listed here
+//
+#if DECODE_NEC
+	extern const irlag_t  irLagNEC;
+#endif
+#if DECODE_SONY
+	extern const irlag_t  irLagSony;
+#endif
+#if DECODE_PANASONIC
+	extern const irlag_t  irLagPanasonic;
+#endif
+#if DECODE_JVC
+	extern const irlag_t  irLagJVC;
+#endif
 #if DECODE_SAMSUNG
-	DBG_PRINTLN("Attempting SAMSUNG decode");
-	if (decodeSAMSUNG(results))  return true ;
+	extern const irlag_t  irLagSAMSUNG;
+#endif
+#if DECODE_WHYNTER
+	extern const irlag_t  irLagWhynter;
 #endif
+#if DECODE_LG
+	extern const irlag_t  irLagLG;
+#endif
+#if DECODE_DENON
+	extern const irlag_t  irLagDenon;
+#endif
+
+#define IR_LAG_SAMPLES  8  // Fewest intervals a frame must have to learn from
+#define IR_LAG_WEIGHT   8  // Each new estimate moves the lag 1/IR_LAG_WEIGHT of the way
 
+static const irlag_t *  irLagOf (int type)
+{
+	switch (type) {
+#if DECODE_NEC
+		case NEC:        return &irLagNEC;
+#endif
+#if DECODE_SONY
+		case SONY:       return &irLagSony;
+#endif
+#if DECODE_PANASONIC
+		case PANASONIC:  return &irLagPanasonic;
+#endif
+#if DECODE_JVC
+		case JVC:        return &irLagJVC;
+#endif
+#if DECODE_SAMSUNG
+		case SAMSUNG:    return &irLagSAMSUNG;
+#endif
 #if DECODE_WHYNTER
-	DBG_PRINTLN("Attempting Whynter decode");
-	if (decodeWhynter(results))  return true ;
+		case WHYNTER:    return &irLagWhynter;
+#endif
+#if DECODE_LG
+		case LG:         return &irLagLG;
+#endif
+#if DECODE_DENON
+		case DENON:      return &irLagDenon;
 #endif
+		default:         return 0;
+	}
+}
 
-#if DECODE_AIWA_RC_T501
-	DBG_PRINTLN("Attempting Aiwa RC-T501 decode");
-	if (decodeAiwaRCT501(results))  return true ;
+//+=============================================================================
+// The learned lag, less MARK_EXCESS, rounded to ticks
+//
+static int  irLagTicks (volatile irparams_t *ir)
+{
+	int  delta = ir->lagdelta;
+	return (delta + ((delta < 0) ? -(USECPERTICK / 2) : (USECPERTICK / 2))) / USECPERTICK;
+}
+
+//+=============================================================================
+// Shorten the marks and lengthen the spaces of a frame by 'ticks' (the gap is
+//   left alone), so the decoders' MARK_EXCESS bounds fit this receiver
+//
+static void  irLagApply (volatile irtick_t *buf,  int len,  int ticks)
+{
+	for (int i = 1;  i < len;  i++) {
+		int  t = buf[i] + ((i & 1) ? -ticks : ticks);
+		buf[i] = (t <= 0) ? 0 : (t >= IR_TICK_MAX) ? IR_TICK_MAX : t;
+	}
+}
+
+//+=============================================================================
+// Refine the learned lag from a decoded frame, which had 'ticks' applied
+//
+static void  irLagLearn (volatile irparams_t *ir,  const decode_results *results,  int ticks)
+{
+	const irlag_t  *p = irLagOf(results->decode_type);
+	unsigned long  sum = 0;
+	int            n   = 0;
+
+	if (!p)  return ;
+
+	for (int i = p->first;  i < results->rawlen;  i += 2, n++)  sum += results->rawbuf[i] ;
+	if (n < IR_LAG_SAMPLES)  return ;
+
+	// Average length as the detector gave it, in uS (ticks round down, so add half)
+	long  us  = ((sum * USECPERTICK) / n) + (USECPERTICK / 2);
+	long  lag = (p->first & 1) ? (us + (ticks * USECPERTICK) - p->us)
+	                           : (p->us - (us - (ticks * USECPERTICK)));
+
+	ir->lagdelta += (int)((lag - MARK_EXCESS - ir->lagdelta) / IR_LAG_WEIGHT);
+}
 #endif
 
-#if DECODE_DENON
-	DBG_PRINTLN("Attempting Denon decode");
-	if (decodeDenon(results))  return true ;
+//+=============================================================================
+// Codes of up to 32 bits only set results->value; copy it to results->data[]
+//   so that data[] holds every code, first bit in the MSB of data[0]
+//
+static void  irValueData (decode_results *results)
+{
+	if ((results->bits > 32) || (results->bits <= 0))  return ;  // The decoder filled data[] itself
+
+	// First bit to the top, then a byte at a time
+	uint32_t  v = (uint32_t)results->value << (32 - results->bits);
+	for (int i = 0;  i < (results->bits + 7) / 8;  i++, v <<= 8)  results->data[i] = v >> 24 ;
+}
+
+#if IR_STATS
+//+=============================================================================
+// Count a frame decode() has finished with : Decoded, unless results is 0
+//
+static void  irTally (irstats_t *counts,  const decode_results *results,  unsigned long us)
+{
+	if (results)  counts->decoded[results->decode_type + 1]++ ;
+	else          counts->dropped++ ;
+	if (us > counts->decodemax)  counts->decodemax = us ;
+}
+
+#	define IR_COUNTS  (&counts)
+#else
+#	define IR_COUNTS  0
 #endif
 
-	// decodeHash returns a hash on any input.
-	// Thus, it needs to be last in the list.
-	// If you add any decodes, add them before this.
-	if (decodeHash(results))  return true ;
+//+=============================================================================
+// Decodes the received IR message
+// Returns 0 if no data ready, 1 if data ready.
+// Results of decoding are stored in results
+// The oldest queued frame is decoded; it stays valid until resume()
+// Decoding it again before resume() gives the same result : Its lag is only
+//   applied, learned from and counted the first time
+// A frame no decoder takes is dropped, the first time or a later one, so a
+//   failed decode() always moves on to the next queued frame
+//
+int  IRrecv::decode (decode_results *results)
+{
+	irEdgeGap(ir);
+
+	// Done sending? Then the timer goes back to sampling the receivers
+	// (after sendAsync() the ISR does that when the queue has gone out)
+#if IR_SEND_QUEUE
+	if (irtxtimer && !irsendcount) {
+#else
+	if (irtxtimer) {
+#endif
+		cli();
+		if (irtxtimer)  irRecvResume() ;
+		sei();
+	}
+
+#if IR_STREAM
+	// A code the ISR has already decoded from the frame still being recorded
+	// Queued frames are older, so they go first
+	cli();
+	ir->streamout = !ir->frames && (ir->streamready == IR_STREAM_READY);
+	if (ir->streamout) {
+		ir->streamready = IR_STREAM_TAKEN;
+		results->decode_type  = (decode_type_t)ir->streamtype;
+		results->value        = ir->streamvalue;
+		results->bits         = ir->streambits;
+		results->rawbuf.frame = ir->rawbuf;
+		results->rawbuf.wide  = 0;
+		results->rawbuf.gap   = ir->framegap[ir->framehead];
+		results->rawlen       = ir->streamlen;
+		results->overflow     = false;
+	}
+	sei();
+	if (ir->streamout) {
+		irValueData(results);
+#if IR_STATS
+		irTally(&counts, results, 0);
+#endif
+		return true;
+	}
+#endif
+
+	if (!ir->frames)  return false ;
+
+	results->rawbuf.frame = ir->rawframes[ir->frametail];
+	results->rawbuf.wide  = 0;
+	results->rawbuf.gap   = ir->framegap[ir->frametail];
+	results->rawlen       = ir->framelen[ir->frametail];
+	results->overflow     = ir->frameovf[ir->frametail];
+
+	bool  seen = ir->frameseen[ir->frametail];
+	ir->frameseen[ir->frametail] = 1;
+	if (seen) {
+		if (decoders(this, results, 0)) {
+			irValueData(results);
+			return true;
+		}
+		resume();  // Throw it away, as below
+		return false;
+	}
+
+#if IR_STATS
+	unsigned long  start = micros();
+#endif
+
+#if IR_ADAPT_LAG
+	int  lagticks = irLagTicks(ir);
+	if (lagticks)  irLagApply(ir->rawframes[ir->frametail], results->rawlen, lagticks) ;
+#endif
+
+	bool  ok = decoders(this, results, IR_COUNTS);
+#if IR_STATS
+	irTally(&counts, ok ? results : 0, micros() - start);
+#endif
+
+	if (ok) {
+#if IR_ADAPT_LAG
+		irLagLearn(ir, results, lagticks);
+#endif
+		orderLearn(results->decode_type);
+		irValueData(results);
+		return true;
+	}
 
 	// Throw away and start over
 	resume();
 	return false;
 }
 
+//+=============================================================================
+// Decodes a capture which did not come from the receiver, eg. a saved one
+// ticks[0] is the gap before the code, then alternate marks and spaces, all in
+//   50uS ticks : the same layout as results->rawbuf after decode()
+// The receiver's learned lag is neither applied nor updated
+// Reads nothing but ticks[] and writes nothing but *results, so it is safe to
+//   call from several threads at once (see extras/host)
+// Returns 0 if the capture is too short to even hash (less than the gap and
+//   one mark is not read at all), 1 otherwise
+//
+int  IRrecv::decode (const unsigned int *ticks,  int n,  decode_results *results)
+{
+	if (n < 2)  return false ;
+
+	results->rawbuf.frame = 0;
+	results->rawbuf.wide  = ticks;
+	results->rawbuf.gap   = ticks[0];
+	results->rawlen       = n;
+	results->overflow     = false;
+
+	if (!decoders(this, results, 0))  return false ;
+	irValueData(results);
+	return true;
+}
+
+//+=============================================================================
+// Run the decoders over results->rawbuf / results->rawlen
+// Only those of the protocols with an onDecode() handler, if there are any
+// Each decoder run is counted in counts->tries[], unless counts is 0
+//
+#define IR_WANTS(type)  (!wanted || (wanted & (1UL << ((type) + 1))))
+
+#if IR_STATS
+#	define IR_TRIED(type)  do { if (counts)  counts->tries[(type) + 1]++ ; } while (0)
+#else
+#	define IR_TRIED(type)
+#endif
+
+bool  IRrecv::decodeFrame (decode_results *results,  irstats_t *counts)
+{
+	// Classify the gap and header mark once; only try the decoders they fit
+	unsigned int  gap = results->rawbuf[0];
+	unsigned int  hdr = results->rawbuf[1];
+
+#if DECODE_PULSE_DISTANCE
+	// Longer than any named protocol : Do not let one of them take the first bits
+	if (IR_WANTS(PULSE_DISTANCE) && (results->rawlen > (2 * IR_NAMED_MAX_BITS) + 4)) {
+		DBG_PRINTLN("Attempting PulseDistance decode");
+		IR_TRIED(PULSE_DISTANCE);
+		if (decodePulseDistance(results))  return true ;
+	}
+#endif
+
+	// The named protocols whose windows the frame fits
+	static_assert(sizeof(decoderTable) == IR_DECODERS * sizeof(decoderTable[0]), "IR_DECODERS does not match decoderTable[]");
+	for (uint8_t k = 0;  k < IR_DECODERS;  k++) {
+#if IR_ADAPT_ORDER
+		uint8_t      i = order[k];
+#else
+		uint8_t      i = k;
+#endif
+		irdecoder_t  d;
+
+		memcpy_P(&d, &decoderTable[i], sizeof(d));
+		if (!IR_WANTS(d.type) || !irCandidate(d.windows, gap, hdr))  continue ;
+		DBG_PRINT("Attempting decode of type ");
+		DBG_PRINTLN(d.type, DEC);
+		IR_TRIED(d.type);
+		if ((this->*d.decode)(results))  return true ;
+	}
+
+#if DECODE_PULSE_DISTANCE
+	// Long codes whose timing no decoder above knows; no windows, any header will do
+	if (IR_WANTS(PULSE_DISTANCE) && (results->rawlen <= (2 * IR_NAMED_MAX_BITS) + 4)) {
+		DBG_PRINTLN("Attempting PulseDistance decode");
+		IR_TRIED(PULSE_DISTANCE);
+		if (decodePulseDistance(results))  return true ;
+	}
+#endif
+
+	// decodeHash returns a hash on any input.
+	// Thus, it needs to be last in the list.
+	// If you add any decodes, add them before this.
+	if (!IR_WANTS(UNKNOWN))  return false ;
+	IR_TRIED(UNKNOWN);
+	return decodeHash(results);
+}
+
+//+=============================================================================
+// The decoders of an IRrecv(int) : All those built in, in the order above
+//
+bool  IRrecv::decodeAll (IRrecv *irrecv,  decode_results *results,  irstats_t *counts)
+{
+	return irrecv->decodeFrame(results, counts);
+}
+
+//+=============================================================================
+// For IRrecvProtocols<> : Whether to run the decoder of 'type', which is then
+//   counted as tried
+//
+bool  IRrecv::tryType (decode_type_t type,  irstats_t *counts)
+{
+	if (!IR_WANTS(type))  return false ;
+	IR_TRIED(type);
+	return true;
+}
+
+//+=============================================================================
+// May decoderTable[a] be tried before decoderTable[b], which is now ahead of it?
+//
+bool  IRrecv::mayPass (uint8_t a,  uint8_t b)
+{
+	if (pgm_read_byte(&decoderTable[a].pinned) || pgm_read_byte(&decoderTable[b].pinned))  return false ;
+	return !(pgm_read_dword(&decoderTable[a].after) & IR_BIT((int8_t)pgm_read_byte(&decoderTable[b].type)));
+}
+
+//+=============================================================================
+// Count a code decoded by the decoder of 'type'; every IR_ORDER_EVERY codes,
+//   move the decoders which took most of them forward
+//
+void  IRrecv::orderLearn (decode_type_t type)
+{
+#if IR_ADAPT_ORDER
+	for (uint8_t i = 0;  i < IR_DECODERS;  i++) {
+		if ((int8_t)pgm_read_byte(&decoderTable[i].type) != type)  continue ;
+		if (hits[i] < 0xFF)  hits[i]++ ;
+		if (++nhits >= IR_ORDER_EVERY)  reorder() ;
+		return;
+	}
+#endif
+}
+
+//+=============================================================================
+// Sort order[] by hits, most first, as far as mayPass() allows : A decoder
+//   only ever changes places with its neighbour, so one which may not pass
+//   another never does.  Then halve the hits, so a new remote takes over.
+//
+void  IRrecv::reorder ( )
+{
+#if IR_ADAPT_ORDER
+	for (uint8_t pass = 1;  pass < IR_DECODERS;  pass++) {
+		for (uint8_t k = IR_DECODERS - 1;  k > 0;  k--) {
+			uint8_t  a = order[k];
+			uint8_t  b = order[k - 1];
+
+			if ((hits[a] > hits[b]) && mayPass(a, b)) {
+				order[k - 1] = a;
+				order[k]     = b;
+			}
+		}
+	}
+	for (uint8_t i = 0;  i < IR_DECODERS;  i++)  hits[i] >>= 1 ;
+	nhits = 0;
+#endif
+}
+
+//+=============================================================================
+// The decode_types of the decoders decode() picks from, in the order it tries
+//   them (PULSE_DISTANCE and the decodeHash() fallback are not listed)
+//
+int  IRrecv::decodeOrder (decode_type_t *types)
+{
+	for (uint8_t k = 0;  k < IR_DECODERS;  k++) {
+#if IR_ADAPT_ORDER
+		uint8_t  i = order[k];
+#else
+		uint8_t  i = k;
+#endif
+		types[k] = (decode_type_t)(int8_t)pgm_read_byte(&decoderTable[i].type);
+	}
+	return IR_DECODERS;
+}
+
+#ifdef E2END
+//+=============================================================================
+// EEPROM layout from 'address' : The number of decoders, then their
+//   decode_types in the order they are tried
+//
+void  IRrecv::saveOrder (int address)
+{
+	decode_type_t  types[IR_DECODERS];
+	int            n = decodeOrder(types);
+
+	eeprom_update_byte((uint8_t *)(uintptr_t)address, n);
+	for (int k = 0;  k < n;  k++)  eeprom_update_byte((uint8_t *)(uintptr_t)(address + 1 + k), types[k]) ;
+}
+
+//+=============================================================================
+// Start from an order saveOrder() kept, maybe by a build with other decoders :
+//   Those it lists go first, as far as mayPass() allows, the others after
+// Erased EEPROM reads as 0xFF, which is taken as nothing kept
+//
+bool  IRrecv::loadOrder (int address)
+{
+	uint8_t  n = eeprom_read_byte((const uint8_t *)(uintptr_t)address);
+
+	if ((n == 0) || (n > IR_TYPES))  return false ;
+
+#if IR_ADAPT_ORDER
+	// Rank them by hits, then let reorder() sort them
+	memset(hits, 0, sizeof(hits));
+	for (uint8_t k = 0;  k < n;  k++) {
+		int8_t  type = eeprom_read_byte((const uint8_t *)(uintptr_t)(address + 1 + k));
+
+		for (uint8_t i = 0;  i < IR_DECODERS;  i++) {
+			if ((int8_t)pgm_read_byte(&decoderTable[i].type) == type)  hits[i] = 0xFF - k ;
+		}
+	}
+	reorder();
+	memset(hits, 0, sizeof(hits));
+#endif
+	return true;
+}
+#endif
+
+//+=============================================================================
+// The receiver state for a pin : The one already on it, else the first unused
+//   one, else the last (so with IR_RECEIVERS 1, always irparams)
+//
+static volatile irparams_t *  irSlot (int recvpin)
+{
+	uint8_t  r;
+
+	for (r = 0;  r < IR_RECEIVERS - 1;  r++) {
+		if (!irrecvs[r].recvreg || (irrecvs[r].recvpin == recvpin))  break ;
+	}
+	return &irrecvs[r];
+}
+
+#if IR_RECEIVERS > 1
+//+=============================================================================
+// List the port of every receiver once in irPorts[], for irTimerTickAll()
+// Call with interrupts disabled
+//
+static void  irPortsUpdate ( )
+{
+	irNumPorts = 0;
+	for (uint8_t r = 0;  r < IR_RECEIVERS;  r++) {
+		volatile irparams_t  *ir = &irrecvs[r];
+		uint8_t               i;
+
+		if (!ir->recvreg)  continue ;
+		for (i = 0;  (i < irNumPorts) && (irPorts[i] != ir->recvreg);  i++) ;
+		if (i == irNumPorts)  irPorts[irNumPorts++] = ir->recvreg ;
+		ir->recvport = i;
+	}
+}
+#endif
+
 //+=============================================================================
 IRrecv::IRrecv (int recvpin)
+	: decoders(decodeAll)
 {
-	irparams.recvpin = recvpin;
-	irparams.blinkflag = 0;
+	init(recvpin, -1);
 }
 
 IRrecv::IRrecv (int recvpin, int blinkpin)
+	: decoders(decodeAll)
+{
+	init(recvpin, blinkpin);
+}
+
+// For IRrecvProtocols<> : Only its decoders
+IRrecv::IRrecv (int recvpin,  irdecoders_t decoders)
+	: decoders(decoders)
 {
-	irparams.recvpin = recvpin;
-	irparams.blinkpin = blinkpin;
-	pinMode(blinkpin, OUTPUT);
-	irparams.blinkflag = 0;
+	init(recvpin, -1);
 }
 
+IRrecv::IRrecv (int recvpin,  int blinkpin,  irdecoders_t decoders)
+	: decoders(decoders)
+{
+	init(recvpin, blinkpin);
+}
 
+//+=============================================================================
+// Claim the receiver state for the pin; blinkpin -1 : No blink pin
+//
+void  IRrecv::init (int recvpin,  int blinkpin)
+{
+	ir = irSlot(recvpin);
+	ir->recvpin   = recvpin;
+	ir->recvreg   = portInputRegister(digitalPinToPort(recvpin));
+	ir->recvmask  = digitalPinToBitMask(recvpin);
+	ir->rawbuf    = ir->rawframes[0];
+	ir->blinkreg  = 0;
+	if (blinkpin >= 0) {
+		ir->blinkpin  = blinkpin;
+		ir->blinkreg  = blinkpin ? portOutputRegister(digitalPinToPort(blinkpin)) : 0;
+		ir->blinkmask = digitalPinToBitMask(blinkpin);
+		pinMode(blinkpin, OUTPUT);
+	}
+	ir->blinkflag = 0;
+	handler            = 0;
+	nhandlers          = 0;
+	wanted             = 0;
+#if IR_ADAPT_ORDER
+	for (uint8_t i = 0;  i < IR_DECODERS;  i++)  order[i] = i ;
+	memset(hits, 0, sizeof(hits));
+	nhits              = 0;
+#endif
+#if IR_STATS
+	memset(&counts, 0, sizeof(counts));
+#endif
+}
 
 //+=============================================================================
 // initialization
 //
 void  IRrecv::enableIRIn ( )
 {
+	enableIRIn(IR_CAPTURE_TIMER);
+}
+
+//+=============================================================================
+// initialization, selecting the capture engine
+//   IR_CAPTURE_TIMER : Sample the detector from a 50uS timer interrupt
+//   IR_CAPTURE_EDGE  : Interrupt on each detector edge; needs a pin which
+//                      supports attachInterrupt() (2 or 3 on an Uno)
+// If the pin cannot raise an interrupt we fall back to the timer engine
+//
+void  IRrecv::enableIRIn (int capture)
+{
+	enableIRIn(capture, irEdgeISR);
+}
+
+//+=============================================================================
+// As above, with the handler to attach in IR_CAPTURE_EDGE mode
+// IRrecvPin<pin> passes a handler specialised for its pin
+//
+void  IRrecv::enableIRIn (int capture,  void (*edgeisr)(void))
+{
+#if IR_SEND_QUEUE
+	// The timer is running the carrier for sendAsync() : Let it finish
+	while (irsendcount) ;
+#endif
+#if IR_BLAST_CHANNELS
+	while (irblastbusy) ;
+#endif
+	if (irtxtimer)  irRecvResume() ;  // Back from the carrier to a 50uS tick
+
+	// Stop whichever engine was running
+	TIMER_DISABLE_INTR;
+#ifdef digitalPinToInterrupt
+	int  intr = digitalPinToInterrupt(ir->recvpin);
+	if (intr != NOT_AN_INTERRUPT)  detachInterrupt(intr) ;
+
+	// Edge capture has one handler, for the first receiver; the rest use the timer
+	if ((capture == IR_CAPTURE_EDGE) && (intr != NOT_AN_INTERRUPT) && (ir == &irparams)) {
+		// Initialize state machine variables
+		cli();
+		ir->capture  = IR_CAPTURE_EDGE;
+		irFramesReset(ir);
+		ir->lastedge = micros();
+		sei();
+
+		// Set pin modes
+		pinMode(ir->recvpin, INPUT);
+		attachInterrupt(intr, edgeisr, CHANGE);
+
+#if IR_RECEIVERS > 1
+		// The other receivers are still sampled by the timer
+		for (uint8_t r = 1;  r < IR_RECEIVERS;  r++) {
+			if (irrecvs[r].rcvstate)  TIMER_ENABLE_INTR ;
+		}
+#endif
+		return;
+	}
+#endif
+
 	cli();
 	// Setup pulse clock timer interrupt
 	// Prescale /8 (16M/8 = 0.5 microseconds per tick)
@@ -124,14 +779,17 @@ void  IRrecv::enableIRIn ( )
 
 	TIMER_RESET;
 
-	sei();  // enable interrupts
-
 	// Initialize state machine variables
-	irparams.rcvstate = STATE_IDLE;
-	irparams.rawlen = 0;
+	ir->capture  = IR_CAPTURE_TIMER;
+	irFramesReset(ir);
+#if IR_RECEIVERS > 1
+	irPortsUpdate();
+#endif
+
+	sei();  // enable interrupts
 
 	// Set pin modes
-	pinMode(irparams.recvpin, INPUT);
+	pinMode(ir->recvpin, INPUT);
 }
 
 //+=============================================================================
@@ -139,7 +797,7 @@ void  IRrecv::enableIRIn ( )
 //
 void  IRrecv::blink13 (int blinkflag)
 {
-	irparams.blinkflag = blinkflag;
+	ir->blinkflag = blinkflag;
 	if (blinkflag)  pinMode(BLINKLED, OUTPUT) ;
 }
 
@@ -148,15 +806,194 @@ void  IRrecv::blink13 (int blinkflag)
 // 
 bool  IRrecv::isIdle ( ) 
 {
- return (irparams.rcvstate == STATE_IDLE || irparams.rcvstate == STATE_STOP) ? true : false;
+ irEdgeGap(ir);
+ return (ir->rcvstate == STATE_IDLE || ir->rcvstate == STATE_STOP) ? true : false;
 }
 //+=============================================================================
-// Restart the ISR state machine
+// Release the frame returned by decode()
+// If the queue was full the ISR state machine is restarted in the freed slot,
+//   otherwise it has been recording all along and is left alone.
 //
 void  IRrecv::resume ( )
 {
-	irparams.rcvstate = STATE_IDLE;
-	irparams.rawlen = 0;
+#if IR_STREAM
+	// A streamed code is dropped by the ISR when its frame ends
+	if (ir->streamout) {
+		ir->streamout = false;
+		return;
+	}
+#endif
+
+	cli();
+	if (ir->frames) {
+		ir->frames--;
+		if (++ir->frametail >= RAWFRAMES)  ir->frametail = 0 ;
+
+		if (ir->rcvstate == STATE_STOP) {
+			if (++ir->framehead >= RAWFRAMES)  ir->framehead = 0 ;
+			ir->rawbuf   = ir->rawframes[ir->framehead];
+			ir->rawlen   = 0;
+			ir->rcvstate = STATE_IDLE;
+		}
+	} else {
+		ir->rcvstate = STATE_IDLE;
+		ir->rawlen   = 0;
+	}
+	sei();
+}
+
+//+=============================================================================
+// Number of codes which arrived while every frame slot was full
+//
+unsigned int  IRrecv::overruns ( )
+{
+	cli();
+	unsigned int  n = ir->overruns;
+	sei();
+	return n;
+}
+
+//+=============================================================================
+// Receiver lag in uS : How much longer than sent the marks come out (and how
+//   much shorter the spaces), MARK_EXCESS until the receiver has learned better
+// Save it (eg. in EEPROM) and hand it back after a reset to skip relearning
+// With IR_ADAPT_LAG the intervals decode() returns have the difference from
+//   MARK_EXCESS taken out, to the nearest tick
+//
+int  IRrecv::markExcess ( )
+{
+#if IR_ADAPT_LAG
+	return MARK_EXCESS + ir->lagdelta;
+#else
+	return MARK_EXCESS;
+#endif
+}
+
+void  IRrecv::markExcess (int us)
+{
+#if IR_ADAPT_LAG
+	ir->lagdelta = us - MARK_EXCESS;
+#endif
+}
+
+//+=============================================================================
+// Handlers for dispatch() : One for any protocol, and up to IR_HANDLERS for
+//   one protocol each, which take its codes from the first
+// A handler of 0 removes it
+//
+void  IRrecv::onDecode (irhandler_t h)
+{
+	handler = h;
+	listen();
+}
+
+bool  IRrecv::onDecode (decode_type_t type,  irhandler_t h)
+{
+	uint8_t  i;
+
+	for (i = 0;  (i < nhandlers) && (types[i] != type);  i++) ;
+
+	if (!h) {  // Remove
+		if (i == nhandlers)  return true ;
+		nhandlers--;
+		types[i]    = types[nhandlers];
+		handlers[i] = handlers[nhandlers];
+	} else {
+		if (i == IR_HANDLERS)  return false ;
+		if (i == nhandlers)  nhandlers++ ;
+		types[i]    = type;
+		handlers[i] = h;
+	}
+
+	listen();
+	return true;
+}
+
+//+=============================================================================
+// The protocols decodeFrame() tries : With a handler for any protocol, all of
+//   them; otherwise only those with a handler of their own
+//
+void  IRrecv::listen ( )
+{
+	wanted = 0;
+	if (handler)  return ;
+
+	for (uint8_t i = 0;  i < nhandlers;  i++)  wanted |= 1UL << (types[i] + 1) ;
+}
+
+//+=============================================================================
+// Decode every code received since the last call, and hand each to its handler
+// Returns at once unless the ISR has finished a frame, so it can be called on
+//   every pass of loop()
+// Returns the number of codes decoded
+// A frame no handler wants fails decode(), which drops it, so it goes on while
+//   any frames are still queued rather than stopping at the first failure
+//
+int  IRrecv::dispatch ( )
+{
+	decode_results  results;
+	int             n = 0;
+
+	for (;;) {
+		if (!decode(&results)) {
+			if (ir->frames)  continue ;
+			break;
+		}
+
+		irhandler_t  h = handler;
+
+		for (uint8_t i = 0;  i < nhandlers;  i++) {
+			if (types[i] == results.decode_type)  h = handlers[i] ;
+		}
+		if (h)  h(&results) ;
+
+		resume();
+		n++;
+	}
+
+	return n;
+}
+
+//+=============================================================================
+// A snapshot of the receiver's counters (see irstats_t), taken with the ISR
+//   held off so that they all belong to the same moment
+//
+void  IRrecv::stats (irstats_t *snapshot)
+{
+#if IR_STATS
+	*snapshot = counts;
+	cli();
+	snapshot->frames    = ir->framecount;
+	snapshot->overflows = ir->ovfcount;
+	snapshot->overruns  = ir->overruns;
+#	if IR_ECHO_GUARD
+	snapshot->echoes    = ir->echocount;
+#	endif
+	snapshot->isrmax    = irIsrMax;
+	sei();
+#else
+	memset(snapshot, 0, sizeof(*snapshot));
+#endif
+}
+
+//+=============================================================================
+// Start counting again from 0
+// The ISR's longest run is shared by all receivers, so it is cleared for all
+//
+void  IRrecv::clearStats ( )
+{
+#if IR_STATS
+	memset(&counts, 0, sizeof(counts));
+	cli();
+	ir->framecount = 0;
+	ir->ovfcount   = 0;
+	ir->overruns   = 0;
+#	if IR_ECHO_GUARD
+	ir->echocount  = 0;
+#	endif
+	irIsrMax       = 0;
+	sei();
+#endif
 }
 
 //+=============================================================================
@@ -174,13 +1011,13 @@ void  IRrecv::resume ( )
 //
 // Compare two tick values, returning 0 if newval is shorter,
 // 1 if newval is equal, and 2 if newval is longer
-// Use a tolerance of 20%
+// Use a tolerance of 20% (x < y * 0.8, as 5x < 4y)
 //
 int  IRrecv::compare (unsigned int oldval,  unsigned int newval)
 {
-	if      (newval < oldval * .8)  return 0 ;
-	else if (oldval < newval * .8)  return 2 ;
-	else                            return 1 ;
+	if      (5UL * newval < 4UL * oldval)  return 0 ;
+	else if (5UL * oldval < 4UL * newval)  return 2 ;
+	else                                   return 1 ;
 }
 
 //+=============================================================================
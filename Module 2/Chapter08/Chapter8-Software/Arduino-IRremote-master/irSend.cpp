@@ -15,6 +15,146 @@ void  IRsend::sendRaw (unsigned int buf[],  unsigned int len,  unsigned int hz)
 	space(0);  // Always end with the LED off
 }
 
+#if IR_SEND_QUEUE
+//+=============================================================================
+// Send without waiting : Queue buf[] (as for sendRaw) to be played by the timer
+//   ISR, 'repeats' more times after the first copy, with 'gap' mS of silence
+//   after each copy.  buf[] must stay as it is until sending() returns false.
+// Returns false, and sends nothing, if IR_SEND_QUEUE frames are already queued
+//
+bool  IRsend::sendAsync (const unsigned int buf[],  unsigned int len,  unsigned int khz,
+                         uint8_t repeats,  uint8_t gap)
+{
+	return queue(buf, len, IR_SENDQ_RAM, khz, repeats, gap);
+}
+
+//+=============================================================================
+// As above, with buf[] in PROGMEM
+//
+bool  IRsend::sendAsync_P (const unsigned int buf[],  unsigned int len,  unsigned int khz,
+                           uint8_t repeats,  uint8_t gap)
+{
+	return queue(buf, len, IR_SENDQ_P, khz, repeats, gap);
+}
+
+//+=============================================================================
+// As above, for a frame built with IR_FRAME_... or IRrawFrame (see IRremote.h)
+//
+bool  IRsend::sendAsync_P (const uint8_t *frame,  uint8_t repeats,  uint8_t gap)
+{
+	return queue(frame + 2, pgm_read_byte(frame + 1), IR_SENDQ_TICKS, pgm_read_byte(frame), repeats, gap);
+}
+
+//+=============================================================================
+// As above, for a frame in RAM (see sendFrame)
+//
+bool  IRsend::sendAsync (const uint8_t *frame,  uint8_t repeats,  uint8_t gap)
+{
+	return queue(frame + 2, frame[1], IR_SENDQ_RAM8, frame[0], repeats, gap);
+}
+
+//+=============================================================================
+bool  IRsend::queue (const void *buf,  unsigned int len,  uint8_t kind,  unsigned int khz,
+                     uint8_t repeats,  uint8_t gap)
+{
+	volatile irsendq_t  *f;
+
+	// Something going out : Join the queue behind it
+	cli();
+	if (irsendcount) {
+		if (irsendcount == IR_SEND_QUEUE) {
+			sei();
+			return false;
+		}
+		f = &irsendq[(irsendhead + irsendcount) % IR_SEND_QUEUE];
+		f->buf     = buf;
+		f->len     = len;
+		f->kind    = kind;
+		f->khz     = khz;
+		f->repeats = repeats;
+		f->gap     = gap;
+		irsendcount++;
+		sei();
+		return true;
+	}
+	sei();
+
+	// Idle : Start the carrier (which stops the timer ISR), then let the ISR go
+	enableIROut(khz);
+	f = &irsendq[irsendhead];
+	f->buf     = buf;
+	f->len     = len;
+	f->kind    = kind;
+	f->khz     = khz;
+	f->repeats = repeats;
+	f->gap     = gap;
+	irsendi = 0;
+	if ((long)(micros() - irsendend) > 0)  irsendend = micros() ;  // Else wait out the last gap
+	irsendcount = 1;
+	TIMER_ENABLE_INTR;
+	return true;
+}
+
+//+=============================================================================
+// Is a frame queued by sendAsync() still going out?
+//
+bool  IRsend::sending ( )
+{
+	return irsendcount != 0;
+}
+#endif
+
+//+=============================================================================
+// As sendRaw(), with buf[] in PROGMEM : eg.  const unsigned int buf[] PROGMEM = {...};
+//
+void  IRsend::sendRaw_P (const unsigned int buf[],  unsigned int len,  unsigned int khz)
+{
+	// Set IR carrier frequency
+	enableIROut(khz);
+
+	for (unsigned int i = 0;  i < len;  i++) {
+		if (i & 1)  space(pgm_read_word(&buf[i])) ;
+		else        mark (pgm_read_word(&buf[i])) ;
+	}
+
+	space(0);  // Always end with the LED off
+}
+
+//+=============================================================================
+// Send a frame built with IR_FRAME_... or IRrawFrame (see IRremote.h)
+//
+void  IRsend::sendRaw_P (const uint8_t *frame)
+{
+	sendTicks(frame, true);
+}
+
+//+=============================================================================
+// Send a frame in RAM, eg. from irProntoParse()
+//
+void  IRsend::sendFrame (const uint8_t *frame)
+{
+	sendTicks(frame, false);
+}
+
+//+=============================================================================
+void  IRsend::sendTicks (const uint8_t *frame,  bool progmem)
+{
+	uint8_t  len = progmem ? pgm_read_byte(frame + 1) : frame[1] ;
+
+	// Set IR carrier frequency
+	enableIROut(progmem ? pgm_read_byte(frame) : frame[0]);
+
+	for (uint8_t i = 0;  i < len;  i++) {
+		unsigned int  usec = (progmem ? pgm_read_byte(frame + 2 + i) : frame[2 + i]) * USECPERTICK;
+
+		if      (!usec)  continue ;  // LED stays as it is
+		else if (i & 1)  space(usec) ;
+		else             mark (usec) ;
+	}
+
+	space(0);  // Always end with the LED off
+}
+
 //+=============================================================================
 // Sends an IR mark for the specified number of microseconds.
 // The mark output is modulated at the PWM frequency.
@@ -22,6 +162,7 @@ void  IRsend::sendRaw (unsigned int buf[],  unsigned int len,  unsigned int hz)
 void  IRsend::mark (unsigned int time)
 {
 	TIMER_ENABLE_PWM; // Enable pin 3 PWM output
+	irtxled = 1;
 	if (time > 0) custom_delay_usec(time);
 }
 
@@ -33,6 +174,10 @@ void  IRsend::mark (unsigned int time)
 void  IRsend::space (unsigned int time)
 {
 	TIMER_DISABLE_PWM; // Disable pin 3 PWM output
+	if (irtxled) {
+		irtxled = 0;
+		irtxoff = micros();
+	}
 	if (time > 0) IRsend::custom_delay_usec(time);
 }
 
@@ -51,12 +196,28 @@ void  IRsend::space (unsigned int time)
 // To turn the output on and off, we leave the PWM running, but connect and disconnect the output pin.
 // A few hours staring at the ATmega documentation and this will all make sense.
 // See my Secrets of Arduino PWM at http://arcfn.com/2009/07/secrets-of-arduino-pwm.html for details.
+// Waits for any frames queued by sendAsync() or IRblaster first, as they share the timer.
+// Receivers sampled by the timer pause until the code has gone out : Then
+//   IRrecv::decode() (or the ISR, after sendAsync()) hands the timer back to
+//   them, see irRecvResume().  Receivers on edge capture never stop.
 //
 void  IRsend::enableIROut (int khz)
 {
+#if IR_SEND_QUEUE
+	// Let frames queued by sendAsync() go out first
+	while (irsendcount) ;
+#endif
+#if IR_BLAST_CHANNELS
+	// and those of IRblaster, which needs the timer ticking
+	while (irblastbusy) ;
+#endif
+
 	// Disable the Timer2 Interrupt (which is used for receiving IR)
 	TIMER_DISABLE_INTR; //Timer2 Overflow Interrupt
 
+	// Remember to give it back to the receivers it was sampling
+	if (irTimerReceivers())  irtxtimer = 1 ;
+
 	pinMode(TIMER_PWM_PIN, OUTPUT);
 	digitalWrite(TIMER_PWM_PIN, LOW); // When not sending PWM, we want it low
 
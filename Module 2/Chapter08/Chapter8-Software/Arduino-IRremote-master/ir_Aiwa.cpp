@@ -72,20 +72,23 @@ void  IRsend::sendAiwaRCT501 (int code)
 
 //+=============================================================================
 #if DECODE_AIWA_RC_T501
+// Header windows for the dispatcher in IRrecv::decode() : Header mark
+extern const irwindow_t  irWindowsAiwaRCT501[] = { IR_MARK_WINDOW(AIWA_RC_T501_HDR_MARK), IR_WINDOW_END };
+
 bool  IRrecv::decodeAiwaRCT501 (decode_results *results)
 {
 	int  data   = 0;
 	int  offset = 1;
 
 	// Check SIZE
-	if (irparams.rawlen < 2 * (AIWA_RC_T501_SUM_BITS) + 4)  return false ;
+	if (results->rawlen < 2 * (AIWA_RC_T501_SUM_BITS) + 4)  return false ;
 
 	// Check HDR Mark/Space
 	if (!MATCH_MARK (results->rawbuf[offset++], AIWA_RC_T501_HDR_MARK ))  return false ;
 	if (!MATCH_SPACE(results->rawbuf[offset++], AIWA_RC_T501_HDR_SPACE))  return false ;
 
 	offset += 26;  // skip pre-data - optional
-	while(offset < irparams.rawlen - 4) {
+	while(offset < results->rawlen - 4) {
 		if (MATCH_MARK(results->rawbuf[offset], AIWA_RC_T501_BIT_MARK))  offset++ ;
 		else                                                             return false ;
 
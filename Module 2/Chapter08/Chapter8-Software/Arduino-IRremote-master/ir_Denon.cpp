@@ -28,67 +28,43 @@
 #define ONE_SPACE   1800  // The length of a Bit:Space for 1's
 #define ZERO_SPACE   750  // The length of a Bit:Space for 0's
 
+//+=============================================================================
+// Timing for the codec engine (see irCodec.cpp)
+//
+#if SEND_DENON || DECODE_DENON
+static const ircodec_t  irCodecDenon PROGMEM = {
+	DENON,  BITS,  38,  IR_CODEC_EXACT,
+	IR_NO_PAIR,
+	IR_PAIR(HDR_MARK, HDR_SPACE),
+	IR_PAIR(BIT_MARK, ONE_SPACE),
+	IR_PAIR(BIT_MARK, ZERO_SPACE),
+	IR_MARK_ONLY(BIT_MARK),
+	IR_NO_PAIR
+};
+#endif
+
 //+=============================================================================
 //
 #if SEND_DENON
 void  IRsend::sendDenon (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Header
-	mark (HDR_MARK);
-	space(HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark (BIT_MARK);
-			space(ONE_SPACE);
-		} else {
-			mark (BIT_MARK);
-			space(ZERO_SPACE);
-		}
-	}
-
-	// Footer
-	mark(BIT_MARK);
-    space(0);  // Always end with the LED off
+	sendCodec(&irCodecDenon, data, nbits);
 }
 #endif
 
 //+=============================================================================
 //
 #if DECODE_DENON
-bool  IRrecv::decodeDenon (decode_results *results)
-{
-	unsigned long  data   = 0;  // Somewhere to build our code
-	int            offset = 1;  // Skip the Gap reading
-
-	// Check we have the right amount of data
-	if (irparams.rawlen != 1 + 2 + (2 * BITS) + 1)  return false ;
-
-	// Check initial Mark+Space match
-	if (!MATCH_MARK (results->rawbuf[offset++], HDR_MARK ))  return false ;
-	if (!MATCH_SPACE(results->rawbuf[offset++], HDR_SPACE))  return false ;
-
-	// Read the bits in
-	for (int i = 0;  i < BITS;  i++) {
-		// Each bit looks like: MARK + SPACE_1 -> 1
-		//                 or : MARK + SPACE_0 -> 0
-		if (!MATCH_MARK(results->rawbuf[offset++], BIT_MARK))  return false ;
+// Header windows for the dispatcher in IRrecv::decode() : Header mark
+extern const irwindow_t  irWindowsDenon[] = { IR_MARK_WINDOW(HDR_MARK), IR_WINDOW_END };
 
-		// IR data is big-endian, so we shuffle it in from the right:
-		if      (MATCH_SPACE(results->rawbuf[offset], ONE_SPACE))   data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                        return false ;
-		offset++;
-	}
+#if IR_ADAPT_LAG
+// Lag learning (see irlag_t) : Every mark, header included
+extern const irlag_t  irLagDenon = { 1, BIT_MARK };
+#endif
 
-	// Success
-	results->bits        = BITS;
-	results->value       = data;
-	results->decode_type = DENON;
-	return true;
+bool  IRrecv::decodeDenon (decode_results *results)
+{
+	return decodeCodec(results, &irCodecDenon);
 }
 #endif
@@ -29,25 +29,39 @@
 #define DISH_ZERO_SPACE  2800
 #define DISH_RPT_SPACE   6200
 
+//+=============================================================================
+// Timing for the codec engine (see irCodec.cpp)
+// The header space is longer than a gap, so the receiver sees each code as a
+//   frame of its own, ended by the header mark of the next copy : Every copy
+//   but the last decodes
+//
+#if SEND_DISH || DECODE_DISH
+static const ircodec_t  irCodecDISH PROGMEM = {
+	DISH,  DISH_BITS,  56,  0,
+	IR_NO_PAIR,
+	IR_PAIR(DISH_HDR_MARK, DISH_HDR_SPACE),
+	IR_PAIR(DISH_BIT_MARK, DISH_ONE_SPACE),
+	IR_PAIR(DISH_BIT_MARK, DISH_ZERO_SPACE),
+	IR_NO_PAIR,
+	IR_NO_PAIR
+};
+#endif
+
 //+=============================================================================
 #if SEND_DISH
 void  IRsend::sendDISH (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(56);
+	sendCodec(&irCodecDISH, data, nbits);
+}
+#endif
 
-	mark(DISH_HDR_MARK);
-	space(DISH_HDR_SPACE);
+//+=============================================================================
+#if DECODE_DISH
+// Header windows for the dispatcher in IRrecv::decode() : First bit mark
+extern const irwindow_t  irWindowsDISH[] = { IR_MARK_WINDOW(DISH_BIT_MARK), IR_WINDOW_END };
 
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(DISH_BIT_MARK);
-			space(DISH_ONE_SPACE);
-		} else {
-			mark(DISH_BIT_MARK);
-			space(DISH_ZERO_SPACE);
-		}
-	}
+bool  IRrecv::decodeDish (decode_results *results)
+{
+	return decodeCodec(results, &irCodecDISH);
 }
 #endif
-
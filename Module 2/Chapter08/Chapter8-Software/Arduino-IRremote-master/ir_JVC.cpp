@@ -18,84 +18,51 @@
 #define JVC_RPT_LENGTH  60000
 
 //+=============================================================================
+// Timing for the codec engine (see irCodec.cpp)
 // JVC does NOT repeat by sending a separate code (like NEC does).
 // The JVC protocol repeats by skipping the header.
+//
+#if SEND_JVC || DECODE_JVC
+static const ircodec_t  irCodecJVC PROGMEM = {
+	JVC,  JVC_BITS,  38,  IR_CODEC_RPT_BARE,
+	IR_NO_PAIR,
+	IR_PAIR(JVC_HDR_MARK, JVC_HDR_SPACE),
+	IR_PAIR(JVC_BIT_MARK, JVC_ONE_SPACE),
+	IR_PAIR(JVC_BIT_MARK, JVC_ZERO_SPACE),
+	IR_MARK_ONLY(JVC_BIT_MARK),
+	IR_NO_PAIR
+};
+#endif
+
+//+=============================================================================
 // To send a JVC repeat signal, send the original code value
 //   and set 'repeat' to true
 //
 #if SEND_JVC
 void  IRsend::sendJVC (unsigned long data,  int nbits,  bool repeat)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Only send the Header if this is NOT a repeat command
-	if (!repeat){
-		mark(JVC_HDR_MARK);
-		space(JVC_HDR_SPACE);
-	}
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(JVC_BIT_MARK);
-			space(JVC_ONE_SPACE);
-		} else {
-			mark(JVC_BIT_MARK);
-			space(JVC_ZERO_SPACE);
-		}
-	}
-
-	// Footer
-    mark(JVC_BIT_MARK);
-    space(0);  // Always end with the LED off
+	sendCodec(&irCodecJVC, data, nbits, repeat);
 }
 #endif
 
 //+=============================================================================
 #if DECODE_JVC
-bool  IRrecv::decodeJVC (decode_results *results)
-{
-	long  data   = 0;
-	int   offset = 1; // Skip first space
-
-	// Check for repeat
-	if (  (irparams.rawlen - 1 == 33)
-	    && MATCH_MARK(results->rawbuf[offset], JVC_BIT_MARK)
-	    && MATCH_MARK(results->rawbuf[irparams.rawlen-1], JVC_BIT_MARK)
-	   ) {
-		results->bits        = 0;
-		results->value       = REPEAT;
-		results->decode_type = JVC;
-		return true;
-	}
+// Header windows for the dispatcher in IRrecv::decode() : Header mark, or the first bit mark of a repeat
+extern const irwindow_t  irWindowsJVC[] = { IR_MARK_WINDOW(JVC_HDR_MARK), IR_MARK_WINDOW(JVC_BIT_MARK), IR_WINDOW_END };
 
-	// Initial mark
-	if (!MATCH_MARK(results->rawbuf[offset++], JVC_HDR_MARK))  return false ;
-
-	if (irparams.rawlen < (2 * JVC_BITS) + 1 )  return false ;
-
-	// Initial space
-	if (!MATCH_SPACE(results->rawbuf[offset++], JVC_HDR_SPACE))  return false ;
-
-	for (int i = 0;  i < JVC_BITS;  i++) {
-		if (!MATCH_MARK(results->rawbuf[offset++], JVC_BIT_MARK))  return false ;
-
-		if      (MATCH_SPACE(results->rawbuf[offset], JVC_ONE_SPACE))   data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], JVC_ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                            return false ;
-		offset++;
-	}
-
-	// Stop bit
-	if (!MATCH_MARK(results->rawbuf[offset], JVC_BIT_MARK))  return false ;
+#if IR_ADAPT_LAG
+// Lag learning (see irlag_t) : Bit marks (index 3 is one with or without the header)
+extern const irlag_t  irLagJVC = { 3, JVC_BIT_MARK };
+#endif
 
-	// Success
-	results->bits        = JVC_BITS;
-	results->value       = data;
-	results->decode_type = JVC;
+#if IR_EARLY_END
+// Early end of frame (see irend_t) : Repeats have no header, and wait for the gap
+extern const irend_t  irEndJVC PROGMEM = IR_END(JVC_HDR_MARK, JVC_HDR_SPACE, (2 * JVC_BITS) + 4, JVC_ONE_SPACE);
+#endif
 
-	return true;
+bool  IRrecv::decodeJVC (decode_results *results)
+{
+	return decodeCodec(results, &irCodecJVC);
 }
 #endif
 
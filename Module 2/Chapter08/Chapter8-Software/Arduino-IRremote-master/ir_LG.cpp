@@ -19,36 +19,46 @@
 #define LG_RPT_LENGTH 60000
 
 //+=============================================================================
-#if DECODE_LG
-bool  IRrecv::decodeLG (decode_results *results)
-{
-    long  data   = 0;
-    int   offset = 1; // Skip first space
-
-	// Check we have the right amount of data
-    if (irparams.rawlen < (2 * LG_BITS) + 1 )  return false ;
+// Timing for the codec engine (see irCodec.cpp)
+//
+#if SEND_LG || DECODE_LG
+static const ircodec_t  irCodecLG PROGMEM = {
+	LG,  LG_BITS,  38,  0,
+	IR_NO_PAIR,
+	IR_PAIR(LG_HDR_MARK, LG_HDR_SPACE),
+	IR_PAIR(LG_BIT_MARK, LG_ONE_SPACE),
+	IR_PAIR(LG_BIT_MARK, LG_ZERO_SPACE),
+	IR_MARK_ONLY(LG_BIT_MARK),
+	IR_NO_PAIR
+};
+#endif
 
-    // Initial mark/space
-    if (!MATCH_MARK(results->rawbuf[offset++], LG_HDR_MARK))  return false ;
-    if (!MATCH_SPACE(results->rawbuf[offset++], LG_HDR_SPACE))  return false ;
+//+=============================================================================
+#if SEND_LG
+void  IRsend::sendLG (unsigned long data,  int nbits)
+{
+	sendCodec(&irCodecLG, data, nbits);
+}
+#endif
 
-    for (int i = 0;  i < LG_BITS;  i++) {
-        if (!MATCH_MARK(results->rawbuf[offset++], LG_BIT_MARK))  return false ;
+//+=============================================================================
+#if DECODE_LG
+// Header windows for the dispatcher in IRrecv::decode() : Header mark
+extern const irwindow_t  irWindowsLG[] = { IR_MARK_WINDOW(LG_HDR_MARK), IR_WINDOW_END };
 
-        if      (MATCH_SPACE(results->rawbuf[offset], LG_ONE_SPACE))   data = (data << 1) | 1 ;
-        else if (MATCH_SPACE(results->rawbuf[offset], LG_ZERO_SPACE))  data = (data << 1) | 0 ;
-        else                                                           return false ;
-        offset++;
-    }
+#if IR_ADAPT_LAG
+// Lag learning (see irlag_t) : Bit marks
+extern const irlag_t  irLagLG = { 3, LG_BIT_MARK };
+#endif
 
-    // Stop bit
-    if (!MATCH_MARK(results->rawbuf[offset], LG_BIT_MARK))   return false ;
+#if IR_EARLY_END
+// Early end of frame (see irend_t)
+extern const irend_t  irEndLG PROGMEM = IR_END(LG_HDR_MARK, LG_HDR_SPACE, (2 * LG_BITS) + 4, LG_ONE_SPACE);
+#endif
 
-    // Success
-    results->bits        = LG_BITS;
-    results->value       = data;
-    results->decode_type = LG;
-    return true;
+bool  IRrecv::decodeLG (decode_results *results)
+{
+	return decodeCodec(results, &irCodecLG);
 }
 #endif
 
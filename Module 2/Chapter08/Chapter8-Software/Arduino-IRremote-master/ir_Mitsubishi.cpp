@@ -22,13 +22,41 @@
 // #define MITSUBISHI_DOUBLE_SPACE_USECS  800  // usually ssee 713 - not using ticks as get number wrapround
 // #define MITSUBISHI_RPT_LENGTH 45000
 
+// Sending : The capture above, with the receiver lag (MARK_EXCESS) taken back out
+#define MITSUBISHI_BIT_MARK     250  //  7*50-100
+#define MITSUBISHI_ONE_SPACE   2150  // 41*50+100
+#define MITSUBISHI_ZERO_SPACE   950  // 17*50+100
+
+//+=============================================================================
+// Timing for the codec engine (see irCodec.cpp), only for sending : No header
+//
+#if SEND_MITSUBISHI
+static const ircodec_t  irCodecMitsubishi PROGMEM = {
+	MITSUBISHI,  MITSUBISHI_BITS,  38,  0,
+	IR_NO_PAIR,
+	IR_NO_PAIR,
+	IR_PAIR(MITSUBISHI_BIT_MARK, MITSUBISHI_ONE_SPACE),
+	IR_PAIR(MITSUBISHI_BIT_MARK, MITSUBISHI_ZERO_SPACE),
+	IR_MARK_ONLY(MITSUBISHI_BIT_MARK),
+	IR_NO_PAIR
+};
+
+void  IRsend::sendMitsubishi (unsigned long data,  int nbits)
+{
+	sendCodec(&irCodecMitsubishi, data, nbits);
+}
+#endif
+
 //+=============================================================================
 #if DECODE_MITSUBISHI
+// Header windows for the dispatcher in IRrecv::decode() : Leading mark
+extern const irwindow_t  irWindowsMitsubishi[] = { IR_MARK_WINDOW(MITSUBISHI_HDR_SPACE), IR_WINDOW_END };
+
 bool  IRrecv::decodeMitsubishi (decode_results *results)
 {
-  // Serial.print("?!? decoding Mitsubishi:");Serial.print(irparams.rawlen); Serial.print(" want "); Serial.println( 2 * MITSUBISHI_BITS + 2);
+  // Serial.print("?!? decoding Mitsubishi:");Serial.print(results->rawlen); Serial.print(" want "); Serial.println( 2 * MITSUBISHI_BITS + 2);
   long data = 0;
-  if (irparams.rawlen < 2 * MITSUBISHI_BITS + 2)  return false ;
+  if (results->rawlen < 2 * MITSUBISHI_BITS + 2)  return false ;
   int offset = 0; // Skip first space
   // Initial space
 
@@ -60,7 +88,7 @@ bool  IRrecv::decodeMitsubishi (decode_results *results)
   if (!MATCH_MARK(results->rawbuf[offset], MITSUBISHI_HDR_SPACE))  return false ;
   offset++;
 
-  while (offset + 1 < irparams.rawlen) {
+  while (offset + 1 < results->rawlen) {
     if      (MATCH_MARK(results->rawbuf[offset], MITSUBISHI_ONE_MARK))   data = (data << 1) | 1 ;
     else if (MATCH_MARK(results->rawbuf[offset], MITSUBISHI_ZERO_MARK))  data <<= 1 ;
     else                                                                 return false ;
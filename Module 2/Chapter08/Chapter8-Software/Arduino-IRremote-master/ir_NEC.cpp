@@ -17,82 +17,57 @@
 #define NEC_ZERO_SPACE   560
 #define NEC_RPT_SPACE   2250
 
+//+=============================================================================
+// Timing for the codec engine (see irCodec.cpp)
+// NECs have a repeat only 4 items long : Header mark, repeat space, bit mark
+//
+#if SEND_NEC || DECODE_NEC
+static const ircodec_t  irCodecNEC PROGMEM = {
+	NEC,  NEC_BITS,  38,  0,
+	IR_NO_PAIR,
+	IR_PAIR(NEC_HDR_MARK, NEC_HDR_SPACE),
+	IR_PAIR(NEC_BIT_MARK, NEC_ONE_SPACE),
+	IR_PAIR(NEC_BIT_MARK, NEC_ZERO_SPACE),
+	IR_MARK_ONLY(NEC_BIT_MARK),
+	IR_PAIR(NEC_HDR_MARK, NEC_RPT_SPACE)
+};
+#endif
+
 //+=============================================================================
 #if SEND_NEC
 void  IRsend::sendNEC (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Header
-	mark(NEC_HDR_MARK);
-	space(NEC_HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(NEC_BIT_MARK);
-			space(NEC_ONE_SPACE);
-		} else {
-			mark(NEC_BIT_MARK);
-			space(NEC_ZERO_SPACE);
-		}
-	}
-
-	// Footer
-	mark(NEC_BIT_MARK);
-	space(0);  // Always end with the LED off
+	sendCodec(&irCodecNEC, data, nbits);
 }
 #endif
 
 //+=============================================================================
-// NECs have a repeat only 4 items long
-//
 #if DECODE_NEC
-bool  IRrecv::decodeNEC (decode_results *results)
-{
-	long  data   = 0;  // We decode in to here; Start with nothing
-	int   offset = 1;  // Index in to results; Skip first entry!?
-
-	// Check header "mark"
-	if (!MATCH_MARK(results->rawbuf[offset], NEC_HDR_MARK))  return false ;
-	offset++;
-
-	// Check for repeat
-	if ( (irparams.rawlen == 4)
-	    && MATCH_SPACE(results->rawbuf[offset  ], NEC_RPT_SPACE)
-	    && MATCH_MARK (results->rawbuf[offset+1], NEC_BIT_MARK )
-	   ) {
-		results->bits        = 0;
-		results->value       = REPEAT;
-		results->decode_type = NEC;
-		return true;
-	}
+// Header windows for the dispatcher in IRrecv::decode() : Header mark (repeats share it)
+extern const irwindow_t  irWindowsNEC[] = { IR_MARK_WINDOW(NEC_HDR_MARK), IR_WINDOW_END };
 
-	// Check we have enough data
-	if (irparams.rawlen < (2 * NEC_BITS) + 4)  return false ;
-
-	// Check header "space"
-	if (!MATCH_SPACE(results->rawbuf[offset], NEC_HDR_SPACE))  return false ;
-	offset++;
+#if IR_ADAPT_LAG
+// Lag learning (see irlag_t) : Bit marks
+extern const irlag_t  irLagNEC = { 3, NEC_BIT_MARK };
+#endif
 
-	// Build the data
-	for (int i = 0;  i < NEC_BITS;  i++) {
-		// Check data "mark"
-		if (!MATCH_MARK(results->rawbuf[offset], NEC_BIT_MARK))  return false ;
-		offset++;
-        // Suppend this bit
-		if      (MATCH_SPACE(results->rawbuf[offset], NEC_ONE_SPACE ))  data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], NEC_ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                            return false ;
-		offset++;
-	}
+#if IR_EARLY_END
+// Early end of frame (see irend_t) : Code, and repeat
+extern const irend_t  irEndNEC       PROGMEM = IR_END(NEC_HDR_MARK, NEC_HDR_SPACE, (2 * NEC_BITS) + 4, NEC_ONE_SPACE);
+extern const irend_t  irEndNECRepeat PROGMEM = IR_END(NEC_HDR_MARK, NEC_RPT_SPACE, 4, NEC_ONE_SPACE);
+#endif
 
-	// Success
-	results->bits        = NEC_BITS;
-	results->value       = data;
-	results->decode_type = NEC;
+#if IR_STREAM
+// Timing for the streaming decoder in the ISR (see irStreamStep)
+extern const irstream_t  irStreamNEC = {
+	NEC,  NEC_BITS,  0,
+	IR_MARK_RANGE(NEC_HDR_MARK),  IR_SPACE_RANGE(NEC_HDR_SPACE),  IR_SPACE_RANGE(NEC_RPT_SPACE),
+	IR_MARK_RANGE(NEC_BIT_MARK),  IR_SPACE_RANGE(NEC_ONE_SPACE),  IR_SPACE_RANGE(NEC_ZERO_SPACE)
+};
+#endif
 
-	return true;
+bool  IRrecv::decodeNEC (decode_results *results)
+{
+	return decodeCodec(results, &irCodecNEC);
 }
 #endif
@@ -16,63 +16,56 @@
 #define PANASONIC_ONE_SPACE   1244
 #define PANASONIC_ZERO_SPACE   400
 
+//+=============================================================================
+// Timing for the codec engine (see irCodec.cpp) : 16 address bits, then 32 data bits
+//
+#if SEND_PANASONIC || DECODE_PANASONIC
+static const ircodec_t  irCodecPanasonic PROGMEM = {
+	PANASONIC,  PANASONIC_BITS,  35,  0,
+	IR_NO_PAIR,
+	IR_PAIR(PANASONIC_HDR_MARK, PANASONIC_HDR_SPACE),
+	IR_PAIR(PANASONIC_BIT_MARK, PANASONIC_ONE_SPACE),
+	IR_PAIR(PANASONIC_BIT_MARK, PANASONIC_ZERO_SPACE),
+	IR_MARK_ONLY(PANASONIC_BIT_MARK),
+	IR_NO_PAIR
+};
+#endif
+
 //+=============================================================================
 #if SEND_PANASONIC
 void  IRsend::sendPanasonic (unsigned int address,  unsigned long data)
 {
-	// Set IR carrier frequency
-	enableIROut(35);
-
-	// Header
-	mark(PANASONIC_HDR_MARK);
-	space(PANASONIC_HDR_SPACE);
+	uint8_t  bytes[PANASONIC_BITS / 8] = {
+		(uint8_t)(address >> 8),  (uint8_t)address,
+		(uint8_t)(data >> 24),  (uint8_t)(data >> 16),  (uint8_t)(data >> 8),  (uint8_t)data
+	};
 
-	// Address
-	for (unsigned long  mask = 1UL << (16 - 1);  mask;  mask >>= 1) {
-		mark(PANASONIC_BIT_MARK);
-		if (address & mask)  space(PANASONIC_ONE_SPACE) ;
-		else                 space(PANASONIC_ZERO_SPACE) ;
-    }
-
-	// Data
-	for (unsigned long  mask = 1UL << (32 - 1);  mask;  mask >>= 1) {
-        mark(PANASONIC_BIT_MARK);
-        if (data & mask)  space(PANASONIC_ONE_SPACE) ;
-        else              space(PANASONIC_ZERO_SPACE) ;
-    }
-
-	// Footer
-    mark(PANASONIC_BIT_MARK);
-    space(0);  // Always end with the LED off
+	sendCodec(&irCodecPanasonic, bytes, PANASONIC_BITS);
 }
 #endif
 
 //+=============================================================================
 #if DECODE_PANASONIC
-bool  IRrecv::decodePanasonic (decode_results *results)
-{
-    unsigned long long  data   = 0;
-    int                 offset = 1;
-
-    if (!MATCH_MARK(results->rawbuf[offset++], PANASONIC_HDR_MARK ))  return false ;
-    if (!MATCH_MARK(results->rawbuf[offset++], PANASONIC_HDR_SPACE))  return false ;
+// Header windows for the dispatcher in IRrecv::decode() : Header mark
+extern const irwindow_t  irWindowsPanasonic[] = { IR_MARK_WINDOW(PANASONIC_HDR_MARK), IR_WINDOW_END };
 
-    // decode address
-    for (int i = 0;  i < PANASONIC_BITS;  i++) {
-        if (!MATCH_MARK(results->rawbuf[offset++], PANASONIC_BIT_MARK))  return false ;
+#if IR_ADAPT_LAG
+// Lag learning (see irlag_t) : Bit marks
+extern const irlag_t  irLagPanasonic = { 3, PANASONIC_BIT_MARK };
+#endif
 
-        if      (MATCH_SPACE(results->rawbuf[offset],PANASONIC_ONE_SPACE ))  data = (data << 1) | 1 ;
-        else if (MATCH_SPACE(results->rawbuf[offset],PANASONIC_ZERO_SPACE))  data = (data << 1) | 0 ;
-        else                                                                 return false ;
-        offset++;
-    }
+#if IR_EARLY_END
+// Early end of frame (see irend_t)
+extern const irend_t  irEndPanasonic PROGMEM = IR_END(PANASONIC_HDR_MARK, PANASONIC_HDR_SPACE, (2 * PANASONIC_BITS) + 4, PANASONIC_ONE_SPACE);
+#endif
 
-    results->value       = (unsigned long)data;
-    results->address     = (unsigned int)(data >> 32);
-    results->decode_type = PANASONIC;
-    results->bits        = PANASONIC_BITS;
+bool  IRrecv::decodePanasonic (decode_results *results)
+{
+	if (!decodeCodec(results, &irCodecPanasonic))  return false ;
 
-    return true;
+	// value has the data bits; the address is in front of them
+	results->address = (results->data[0] << 8) | results->data[1];
+	return true;
 }
 #endif
 
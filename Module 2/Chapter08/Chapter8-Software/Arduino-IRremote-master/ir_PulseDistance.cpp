@@ -0,0 +1,126 @@
+#include "IRremote.h"
+#include "IRremoteInt.h"
+
+//==============================================================================
+//       PPPP   U   U  L       SSSS  EEEEE       DDDD   IIIII   SSSS  TTTTT
+//       P   P  U   U  L      S      E           D   D    I    S        T
+//       PPPP   U   U  L       SSS   EEE         D   D    I     SSS     T
+//       P      U   U  L          S  E           D   D    I        S    T
+//       P       UUU   LLLLL  SSSS   EEEEE       DDDD   IIIII  SSSS     T
+//==============================================================================
+
+// Any code made of a header mark and space, then bits which are each a fixed
+//   mark and a long (1) or short (0) space, then a final mark.  Most air
+//   conditioners send their whole state this way, in frames far too long for
+//   decode_results.value, and no two makers agree on the timing.  So the
+//   timing is measured from the frame itself, and the bits go in data[].
+//
+// Codes of 32 bits or less are left to the protocol decoders and the hash, so
+//   the values sketches already expect from them do not change.
+
+#define PULSE_DISTANCE_MIN_BITS  33
+#define PULSE_HALF_TICK          (USECPERTICK / 2)
+
+// Two intervals (in ticks) within 25% and a tick of each other
+#define PULSE_ALIKE(a, b)  (((a) <= (b) + ((b) / 4) + 1) && ((b) <= (a) + ((a) / 4) + 1))
+
+//+=============================================================================
+// Send a code decoded by decodePulseDistance() :
+//   irsend.sendPulseDistance(&results.pulses, results.data, results.bits, 38);
+//
+#if SEND_PULSE_DISTANCE
+void  IRsend::sendPulseDistance (const irpulses_t *pulses,  const uint8_t *data,  int nbits,  int khz)
+{
+	// Set IR carrier frequency
+	enableIROut(khz);
+
+	// Header
+	mark (pulses->hdrmark);
+	space(pulses->hdrspace);
+
+	// Data
+	for (int i = 0;  i < nbits;  i++) {
+		mark(pulses->bitmark);
+		if (data[i >> 3] & (0x80 >> (i & 7)))  space(pulses->onespace) ;
+		else                                   space(pulses->zerospace) ;
+	}
+
+	// Footer
+	mark(pulses->bitmark);
+	space(0);  // Always end with the LED off
+}
+#endif
+
+//+=============================================================================
+// results->value gets the last 32 bits, for sketches which only need to tell
+//   a few codes apart
+//
+#if DECODE_PULSE_DISTANCE
+bool  IRrecv::decodePulseDistance (decode_results *results)
+{
+	int            bits    = (results->rawlen - 4) / 2;  // Gap, header mark & space, final mark
+	unsigned int   bitmark;
+	unsigned int   lo      = 0xFFFF;
+	unsigned int   hi      = 0;
+	unsigned int   mid;
+	unsigned long  marks   = 0;
+	unsigned long  ones    = 0;
+	unsigned long  zeros   = 0;
+	int            n1      = 0;
+	uint32_t       value   = 0;
+
+	if ((results->rawlen & 1) || results->overflow)  return false ;
+	if ((bits < PULSE_DISTANCE_MIN_BITS) || (bits > IR_DATA_BYTES * 8))  return false ;
+
+	// Every bit mark alike
+	for (int i = 3;  i < results->rawlen;  i += 2)  marks += results->rawbuf[i] ;
+	bitmark = marks / (bits + 1);
+	if (results->rawbuf[1] < 2 * bitmark)  return false ;  // No header
+	for (int i = 3;  i < results->rawlen;  i += 2) {
+		if (!PULSE_ALIKE(results->rawbuf[i], bitmark))  return false ;
+	}
+
+	// The spaces in two lengths : Split them halfway
+	for (int i = 4;  i < results->rawlen;  i += 2) {
+		unsigned int  t = results->rawbuf[i];
+		if (t < lo)  lo = t ;
+		if (t > hi)  hi = t ;
+	}
+	if (2 * hi < 3 * lo)  return false ;  // All one length : Cannot tell 1 from 0
+	mid = lo + ((hi - lo) / 2);
+
+	// The bits
+	for (int i = 0;  i < bits;  i++) {
+		unsigned int  t   = results->rawbuf[4 + (2 * i)];
+		uint8_t       bit = (t > mid);
+
+		if (bit) {
+			ones += t;
+			n1++;
+		} else {
+			zeros += t;
+		}
+		irDataBit(results, i, bit);
+		value = (value << 1) | bit;
+	}
+
+	// Each space alike the others of its length
+	for (int i = 0;  i < bits;  i++) {
+		unsigned int  t = results->rawbuf[4 + (2 * i)];
+		if (!PULSE_ALIKE(t, (t > mid) ? (ones / n1) : (zeros / (bits - n1))))  return false ;
+	}
+
+	// Timing, back to what was sent (ticks round down, so add half a tick)
+	results->pulses.hdrmark   = (results->rawbuf[1] * USECPERTICK) + PULSE_HALF_TICK - MARK_EXCESS;
+	results->pulses.hdrspace  = (results->rawbuf[2] * USECPERTICK) + PULSE_HALF_TICK + MARK_EXCESS;
+	results->pulses.bitmark   = ((marks * USECPERTICK) / (bits + 1)) + PULSE_HALF_TICK - MARK_EXCESS;
+	results->pulses.onespace  = ((ones  * USECPERTICK) / n1) + PULSE_HALF_TICK + MARK_EXCESS;
+	results->pulses.zerospace = ((zeros * USECPERTICK) / (bits - n1)) + PULSE_HALF_TICK + MARK_EXCESS;
+
+	results->value       = value;
+	results->decode_type = PULSE_DISTANCE;
+	results->bits        = bits;
+
+	return true;
+}
+#endif
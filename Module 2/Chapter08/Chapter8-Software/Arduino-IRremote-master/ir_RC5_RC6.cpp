@@ -7,26 +7,30 @@
 // E.g. if the buffer has MARK for 2 time intervals and SPACE for 1,
 // successive calls to getRClevel will return MARK, MARK, SPACE.
 // offset and used are updated to keep track of the current position.
-// t1 is the time interval for a single bit in microseconds.
+// widths holds the tick bounds of 1, 2 and 3 time intervals (see RC_WIDTHS).
 // Returns -1 for error (measured time interval is not a multiple of t1).
 //
 #if (DECODE_RC5 || DECODE_RC6)
-int  IRrecv::getRClevel (decode_results *results,  int *offset,  int *used,  int t1)
+// Tick bounds of 1, 2 and 3 x t1 : Marks then Spaces
+#define RC_WIDTHS(t1)  {                                                        \
+	IR_MARK_RANGE (t1),  IR_MARK_RANGE (2 * (t1)),  IR_MARK_RANGE (3 * (t1)),  \
+	IR_SPACE_RANGE(t1),  IR_SPACE_RANGE(2 * (t1)),  IR_SPACE_RANGE(3 * (t1))   \
+}
+
+int  IRrecv::getRClevel (decode_results *results,  int *offset,  int *used,  const irrange_t *widths)
 {
-	int  width;
-	int  val;
-	int  correction;
-	int  avail;
+	unsigned int  width;
+	int           val;
+	int           avail;
 
 	if (*offset >= results->rawlen)  return SPACE ;  // After end of recorded buffer, assume SPACE.
 	width      = results->rawbuf[*offset];
 	val        = ((*offset) % 2) ? MARK : SPACE;
-	correction = (val == MARK) ? MARK_EXCESS : - MARK_EXCESS;
+	if (val == SPACE)  widths += 3 ;
 
-	if      (MATCH(width, (  t1) + correction))  avail = 1 ;
-	else if (MATCH(width, (2*t1) + correction))  avail = 2 ;
-	else if (MATCH(width, (3*t1) + correction))  avail = 3 ;
-	else                                         return -1 ;
+	for (avail = 1;  avail <= 3;  avail++, widths++)
+		if ((width >= widths->lo) && (width <= widths->hi))  break ;
+	if (avail > 3)  return -1 ;
 
 	(*used)++;
 	if (*used >= avail) {
@@ -82,6 +86,11 @@ void  IRsend::sendRC5 (unsigned long data,  int nbits)
 
 //+=============================================================================
 #if DECODE_RC5
+// Header windows for the dispatcher in IRrecv::decode() : Start bit : a mark of one to three T1
+extern const irwindow_t  irWindowsRC5[] = { { 1, TICKS_LOW(RC5_T1 + MARK_EXCESS), TICKS_HIGH((3 * RC5_T1) + MARK_EXCESS) }, IR_WINDOW_END };
+// Tick bounds of the RC5 time intervals, for getRClevel()
+static const irrange_t  rc5Widths[] = RC_WIDTHS(RC5_T1);
+
 bool  IRrecv::decodeRC5 (decode_results *results)
 {
 	int   nbits;
@@ -89,16 +98,16 @@ bool  IRrecv::decodeRC5 (decode_results *results)
 	int   used   = 0;
 	int   offset = 1;  // Skip gap space
 
-	if (irparams.rawlen < MIN_RC5_SAMPLES + 2)  return false ;
+	if (results->rawlen < MIN_RC5_SAMPLES + 2)  return false ;
 
 	// Get start bits
-	if (getRClevel(results, &offset, &used, RC5_T1) != MARK)   return false ;
-	if (getRClevel(results, &offset, &used, RC5_T1) != SPACE)  return false ;
-	if (getRClevel(results, &offset, &used, RC5_T1) != MARK)   return false ;
+	if (getRClevel(results, &offset, &used, rc5Widths) != MARK)   return false ;
+	if (getRClevel(results, &offset, &used, rc5Widths) != SPACE)  return false ;
+	if (getRClevel(results, &offset, &used, rc5Widths) != MARK)   return false ;
 
-	for (nbits = 0;  offset < irparams.rawlen;  nbits++) {
-		int  levelA = getRClevel(results, &offset, &used, RC5_T1);
-		int  levelB = getRClevel(results, &offset, &used, RC5_T1);
+	for (nbits = 0;  offset < results->rawlen;  nbits++) {
+		int  levelA = getRClevel(results, &offset, &used, rc5Widths);
+		int  levelB = getRClevel(results, &offset, &used, rc5Widths);
 
 		if      ((levelA == SPACE) && (levelB == MARK ))  data = (data << 1) | 1 ;
 		else if ((levelA == MARK ) && (levelB == SPACE))  data = (data << 1) | 0 ;
@@ -161,6 +170,11 @@ void  IRsend::sendRC6 (unsigned long data,  int nbits)
 
 //+=============================================================================
 #if DECODE_RC6
+// Header windows for the dispatcher in IRrecv::decode() : Header mark
+extern const irwindow_t  irWindowsRC6[] = { IR_MARK_WINDOW(RC6_HDR_MARK), IR_WINDOW_END };
+// Tick bounds of the RC6 time intervals, for getRClevel()
+static const irrange_t  rc6Widths[] = RC_WIDTHS(RC6_T1);
+
 bool  IRrecv::decodeRC6 (decode_results *results)
 {
 	int   nbits;
@@ -175,22 +189,22 @@ bool  IRrecv::decodeRC6 (decode_results *results)
 	if (!MATCH_SPACE(results->rawbuf[offset++], RC6_HDR_SPACE))  return false ;
 
 	// Get start bit (1)
-	if (getRClevel(results, &offset, &used, RC6_T1) != MARK)   return false ;
-	if (getRClevel(results, &offset, &used, RC6_T1) != SPACE)  return false ;
+	if (getRClevel(results, &offset, &used, rc6Widths) != MARK)   return false ;
+	if (getRClevel(results, &offset, &used, rc6Widths) != SPACE)  return false ;
 
 	for (nbits = 0;  offset < results->rawlen;  nbits++) {
 		int  levelA, levelB;  // Next two levels
 
-		levelA = getRClevel(results, &offset, &used, RC6_T1);
+		levelA = getRClevel(results, &offset, &used, rc6Widths);
 		if (nbits == 3) {
 			// T bit is double wide; make sure second half matches
-			if (levelA != getRClevel(results, &offset, &used, RC6_T1)) return false;
+			if (levelA != getRClevel(results, &offset, &used, rc6Widths)) return false;
 		}
 
-		levelB = getRClevel(results, &offset, &used, RC6_T1);
+		levelB = getRClevel(results, &offset, &used, rc6Widths);
 		if (nbits == 3) {
 			// T bit is double wide; make sure second half matches
-			if (levelB != getRClevel(results, &offset, &used, RC6_T1)) return false;
+			if (levelB != getRClevel(results, &offset, &used, rc6Widths)) return false;
 		}
 
 		if      ((levelA == MARK ) && (levelB == SPACE))  data = (data << 1) | 1 ;  // inverted compared to RC5
@@ -17,76 +17,68 @@
 #define SAMSUNG_ZERO_SPACE   560
 #define SAMSUNG_RPT_SPACE   2250
 
+//+=============================================================================
+// Timing for the codec engine (see irCodec.cpp)
+// SAMSUNGs have a repeat only 4 items long : Header mark, repeat space, bit mark
+//
+#if SEND_SAMSUNG || DECODE_SAMSUNG
+static const ircodec_t  irCodecSAMSUNG PROGMEM = {
+	SAMSUNG,  SAMSUNG_BITS,  38,  0,
+	IR_NO_PAIR,
+	IR_PAIR(SAMSUNG_HDR_MARK, SAMSUNG_HDR_SPACE),
+	IR_PAIR(SAMSUNG_BIT_MARK, SAMSUNG_ONE_SPACE),
+	IR_PAIR(SAMSUNG_BIT_MARK, SAMSUNG_ZERO_SPACE),
+	IR_MARK_ONLY(SAMSUNG_BIT_MARK),
+	IR_PAIR(SAMSUNG_HDR_MARK, SAMSUNG_RPT_SPACE)
+};
+#endif
+
 //+=============================================================================
 #if SEND_SAMSUNG
 void  IRsend::sendSAMSUNG (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Header
-	mark(SAMSUNG_HDR_MARK);
-	space(SAMSUNG_HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(SAMSUNG_BIT_MARK);
-			space(SAMSUNG_ONE_SPACE);
-		} else {
-			mark(SAMSUNG_BIT_MARK);
-			space(SAMSUNG_ZERO_SPACE);
-		}
-	}
-
-	// Footer
-	mark(SAMSUNG_BIT_MARK);
-    space(0);  // Always end with the LED off
+	sendCodec(&irCodecSAMSUNG, data, nbits);
 }
 #endif
 
 //+=============================================================================
-// SAMSUNGs have a repeat only 4 items long
-//
 #if DECODE_SAMSUNG
-bool  IRrecv::decodeSAMSUNG (decode_results *results)
-{
-	long  data   = 0;
-	int   offset = 1;  // Skip first space
-
-	// Initial mark
-	if (!MATCH_MARK(results->rawbuf[offset], SAMSUNG_HDR_MARK))   return false ;
-	offset++;
+// Header windows for the dispatcher in IRrecv::decode() : Header mark (repeats share it)
+extern const irwindow_t  irWindowsSAMSUNG[] = { IR_MARK_WINDOW(SAMSUNG_HDR_MARK), IR_WINDOW_END };
 
-	// Check for repeat
-	if (    (irparams.rawlen == 4)
-	     && MATCH_SPACE(results->rawbuf[offset], SAMSUNG_RPT_SPACE)
-	     && MATCH_MARK(results->rawbuf[offset+1], SAMSUNG_BIT_MARK)
-	   ) {
-		results->bits        = 0;
-		results->value       = REPEAT;
-		results->decode_type = SAMSUNG;
-		return true;
-	}
-	if (irparams.rawlen < (2 * SAMSUNG_BITS) + 4)  return false ;
-
-	// Initial space
-	if (!MATCH_SPACE(results->rawbuf[offset++], SAMSUNG_HDR_SPACE))  return false ;
+#if IR_ADAPT_LAG
+// Lag learning (see irlag_t) : Bit marks
+extern const irlag_t  irLagSAMSUNG = { 3, SAMSUNG_BIT_MARK };
+#endif
 
-	for (int i = 0;  i < SAMSUNG_BITS;   i++) {
-		if (!MATCH_MARK(results->rawbuf[offset++], SAMSUNG_BIT_MARK))  return false ;
+#if IR_EARLY_END
+// Early end of frame (see irend_t) : Code, and repeat
+extern const irend_t  irEndSAMSUNG       PROGMEM = IR_END(SAMSUNG_HDR_MARK, SAMSUNG_HDR_SPACE, (2 * SAMSUNG_BITS) + 4, SAMSUNG_ONE_SPACE);
+extern const irend_t  irEndSAMSUNGRepeat PROGMEM = IR_END(SAMSUNG_HDR_MARK, SAMSUNG_RPT_SPACE, 4, SAMSUNG_ONE_SPACE);
+#endif
 
-		if      (MATCH_SPACE(results->rawbuf[offset], SAMSUNG_ONE_SPACE))   data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], SAMSUNG_ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                                return false ;
-		offset++;
-	}
+#if IR_STREAM
+// Timing for the streaming decoder in the ISR (see irStreamStep)
+// decodeSanyo() and decodeSony() run first, and report any long code after
+//   a gap of under 800 (Sanyo) or 500 (Sony) ticks as a repeat; leave those
+//   to decode() so the result is the same
+#	if DECODE_SANYO
+#		define SAMSUNG_STREAM_GAP  800
+#	elif DECODE_SONY
+#		define SAMSUNG_STREAM_GAP  500
+#	else
+#		define SAMSUNG_STREAM_GAP  0
+#	endif
+extern const irstream_t  irStreamSAMSUNG = {
+	SAMSUNG,  SAMSUNG_BITS,  SAMSUNG_STREAM_GAP,
+	IR_MARK_RANGE(SAMSUNG_HDR_MARK),  IR_SPACE_RANGE(SAMSUNG_HDR_SPACE),  IR_SPACE_RANGE(SAMSUNG_RPT_SPACE),
+	IR_MARK_RANGE(SAMSUNG_BIT_MARK),  IR_SPACE_RANGE(SAMSUNG_ONE_SPACE),  IR_SPACE_RANGE(SAMSUNG_ZERO_SPACE)
+};
+#endif
 
-	// Success
-	results->bits        = SAMSUNG_BITS;
-	results->value       = data;
-	results->decode_type = SAMSUNG;
-	return true;
+bool  IRrecv::decodeSAMSUNG (decode_results *results)
+{
+	return decodeCodec(results, &irCodecSAMSUNG);
 }
 #endif
 
@@ -20,14 +20,41 @@
 #define SANYO_DOUBLE_SPACE_USECS    800  // usually ssee 713 - not using ticks as get number wrapround
 #define SANYO_RPT_LENGTH          45000
 
+//+=============================================================================
+// Timing for the codec engine (see irCodec.cpp), only for sending
+// decodeSanyo() checks the intervals as the receiver saw them : Two header
+//   intervals of SANYO_HDR_MARK, then for each bit a SANYO_HDR_SPACE and a
+//   SANYO_ONE_MARK or SANYO_ZERO_MARK.  Send those, with the receiver lag
+//   (MARK_EXCESS) taken back out.
+//
+#if SEND_SANYO
+static const ircodec_t  irCodecSanyo PROGMEM = {
+	SANYO,  SANYO_BITS,  38,  0,
+	IR_NO_PAIR,
+	IR_PAIR(SANYO_HDR_MARK - MARK_EXCESS,   SANYO_HDR_MARK + MARK_EXCESS),
+	IR_PAIR(SANYO_HDR_SPACE - MARK_EXCESS,  SANYO_ONE_MARK + MARK_EXCESS),
+	IR_PAIR(SANYO_HDR_SPACE - MARK_EXCESS,  SANYO_ZERO_MARK + MARK_EXCESS),
+	IR_MARK_ONLY(SANYO_HDR_SPACE - MARK_EXCESS),
+	IR_NO_PAIR
+};
+
+void  IRsend::sendSanyo (unsigned long data,  int nbits)
+{
+	sendCodec(&irCodecSanyo, data, nbits);
+}
+#endif
+
 //+=============================================================================
 #if DECODE_SANYO
+// Header windows for the dispatcher in IRrecv::decode() : Short gap (fast repeat) or header mark
+extern const irwindow_t  irWindowsSanyo[] = { IR_GAP_BELOW(SANYO_DOUBLE_SPACE_USECS), IR_MARK_WINDOW(SANYO_HDR_MARK), IR_WINDOW_END };
+
 bool  IRrecv::decodeSanyo (decode_results *results)
 {
 	long  data   = 0;
 	int   offset = 0;  // Skip first space  <-- CHECK THIS!
 
-	if (irparams.rawlen < (2 * SANYO_BITS) + 2)  return false ;
+	if (results->rawlen < (2 * SANYO_BITS) + 2)  return false ;
 
 #if 0
 	// Put this back in for debugging - note can't use #DEBUG as if Debug on we don't see the repeat cos of the delay
@@ -53,7 +80,7 @@ bool  IRrecv::decodeSanyo (decode_results *results)
 	// Skip Second Mark
 	if (!MATCH_MARK(results->rawbuf[offset++], SANYO_HDR_MARK))  return false ;
 
-	while (offset + 1 < irparams.rawlen) {
+	while (offset + 1 < results->rawlen) {
 		if (!MATCH_SPACE(results->rawbuf[offset++], SANYO_HDR_SPACE))  break ;
 
 		if      (MATCH_MARK(results->rawbuf[offset], SANYO_ONE_MARK))   data = (data << 1) | 1 ;
@@ -62,8 +89,8 @@ bool  IRrecv::decodeSanyo (decode_results *results)
 		offset++;
 	}
 
-	// Success
-	results->bits = (offset - 1) / 2;
+	// Success : Each bit is a pair after the gap and the two header marks
+	results->bits = (offset - 3) / 2;
 	if (results->bits < 12) {
 		results->bits = 0;
 		return false;
@@ -30,28 +30,31 @@
 #define SHARP_RPT_SPACE      3000
 
 #define SHARP_TOGGLE_MASK  0x3FF
+#define SHARP_EXPANSION      0x02  // Set in a code, clear in its inverted copy
+
+//+=============================================================================
+// Timing for the codec engine (see irCodec.cpp) : No header
+//
+#if SEND_SHARP || DECODE_SHARP
+static const ircodec_t  irCodecSharp PROGMEM = {
+	SHARP,  SHARP_BITS,  38,  0,
+	IR_NO_PAIR,
+	IR_NO_PAIR,
+	IR_PAIR(SHARP_BIT_MARK, SHARP_ONE_SPACE),
+	IR_PAIR(SHARP_BIT_MARK, SHARP_ZERO_SPACE),
+	IR_PAIR(SHARP_BIT_MARK, SHARP_ZERO_SPACE),
+	IR_NO_PAIR
+};
+#endif
 
 //+=============================================================================
 #if SEND_SHARP
 void  IRsend::sendSharpRaw (unsigned long data,  int nbits)
 {
-	enableIROut(38);
-
 	// Sending codes in bursts of 3 (normal, inverted, normal) makes transmission
 	// much more reliable. That's the exact behaviour of CD-S6470 remote control.
 	for (int n = 0;  n < 3;  n++) {
-		for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-			if (data & mask) {
-				mark(SHARP_BIT_MARK);
-				space(SHARP_ONE_SPACE);
-			} else {
-				mark(SHARP_BIT_MARK);
-				space(SHARP_ZERO_SPACE);
-			}
-		}
-
-		mark(SHARP_BIT_MARK);
-		space(SHARP_ZERO_SPACE);
+		sendCodec(&irCodecSharp, data, nbits);
 		delay(40);
 
 		data = data ^ SHARP_TOGGLE_MASK;
@@ -61,7 +64,6 @@ void  IRsend::sendSharpRaw (unsigned long data,  int nbits)
 
 //+=============================================================================
 // Sharp send compatible with data obtained through decodeSharp()
-//                                                  ^^^^^^^^^^^^^ FUNCTION MISSING!
 //
 #if SEND_SHARP
 void  IRsend::sendSharp (unsigned int address,  unsigned int command)
@@ -69,3 +71,23 @@ void  IRsend::sendSharp (unsigned int address,  unsigned int command)
 	sendSharpRaw((address << 10) | (command << 2) | 2, SHARP_BITS);
 }
 #endif
+
+//+=============================================================================
+// Each copy decodes to the code sendSharpRaw() was given : The inverted one
+//   is turned back.  results->address gets the address bits.
+// Denon sends the same way (see ir_Denon.cpp) and is tried first, so a code
+//   which starts with a 0 bit decodes as DENON.
+//
+#if DECODE_SHARP
+// Header windows for the dispatcher in IRrecv::decode() : First bit mark
+extern const irwindow_t  irWindowsSharp[] = { IR_MARK_WINDOW(SHARP_BIT_MARK), IR_WINDOW_END };
+
+bool  IRrecv::decodeSharp (decode_results *results)
+{
+	if (!decodeCodec(results, &irCodecSharp))  return false ;
+
+	if (!(results->value & SHARP_EXPANSION))  results->value ^= SHARP_TOGGLE_MASK ;
+	results->address = results->value >> 10;
+	return true;
+}
+#endif
@@ -17,40 +17,46 @@
 #define SONY_RPT_LENGTH          45000
 #define SONY_DOUBLE_SPACE_USECS    500  // usually ssee 713 - not using ticks as get number wrapround
 
+//+=============================================================================
+// Timing for the codec engine (see irCodec.cpp) : Bits are in the marks
+// Only for sending; decodeSony() takes codes of any length from 12 bits
+//
+#if SEND_SONY
+static const ircodec_t  irCodecSony PROGMEM = {
+	SONY,  SONY_BITS,  40,  0,
+	IR_NO_PAIR,
+	IR_PAIR(SONY_HDR_MARK,  SONY_HDR_SPACE),
+	IR_PAIR(SONY_ONE_MARK,  SONY_HDR_SPACE),
+	IR_PAIR(SONY_ZERO_MARK, SONY_HDR_SPACE),
+	IR_NO_PAIR,  // We will have ended with LED off
+	IR_NO_PAIR
+};
+#endif
+
 //+=============================================================================
 #if SEND_SONY
 void  IRsend::sendSony (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(40);
-
-	// Header
-	mark(SONY_HDR_MARK);
-	space(SONY_HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(SONY_ONE_MARK);
-			space(SONY_HDR_SPACE);
-		} else {
-			mark(SONY_ZERO_MARK);
-			space(SONY_HDR_SPACE);
-    	}
-  	}
-
-	// We will have ended with LED off
+	sendCodec(&irCodecSony, data, nbits);
 }
 #endif
 
 //+=============================================================================
 #if DECODE_SONY
+// Header windows for the dispatcher in IRrecv::decode() : Short gap (fast repeat) or header mark
+extern const irwindow_t  irWindowsSony[] = { IR_GAP_BELOW(SONY_DOUBLE_SPACE_USECS), IR_MARK_WINDOW(SONY_HDR_MARK), IR_WINDOW_END };
+
+#if IR_ADAPT_LAG
+// Lag learning (see irlag_t) : Spaces, as Sony encodes its bits in the marks
+extern const irlag_t  irLagSony = { 2, SONY_HDR_SPACE };
+#endif
+
 bool  IRrecv::decodeSony (decode_results *results)
 {
 	long  data   = 0;
 	int   offset = 0;  // Dont skip first space, check its size
 
-	if (irparams.rawlen < (2 * SONY_BITS) + 2)  return false ;
+	if (results->rawlen < (2 * SONY_BITS) + 2)  return false ;
 
 	// Some Sony's deliver repeats fast after first
 	// unfortunately can't spot difference from of repeat from two fast clicks
@@ -72,7 +78,7 @@ bool  IRrecv::decodeSony (decode_results *results)
 	// Initial mark
 	if (!MATCH_MARK(results->rawbuf[offset++], SONY_HDR_MARK))  return false ;
 
-	while (offset + 1 < irparams.rawlen) {
+	while (offset + 1 < results->rawlen) {
 		if (!MATCH_SPACE(results->rawbuf[offset++], SONY_HDR_SPACE))  break ;
 
 		if      (MATCH_MARK(results->rawbuf[offset], SONY_ONE_MARK))   data = (data << 1) | 1 ;
@@ -48,23 +48,36 @@ Now you must do a few things to add it to the IRremote system:
           bool  decodeShuzu (decode_results *results) ;
       #endif
 
-   D. Further down in "Main class for sending IR", add:
+   D. Further down, with the decoders for IRrecvProtocols<>, add:
+      #if DECODE_SHUZU
+          IR_DECODER(SHUZU, decodeShuzu)
+      #endif
+
+   E. Further down in "Main class for sending IR", add:
       //......................................................................
       #if SEND_SHUZU
           void  sendShuzu (unsigned long data,  int nbits) ;
       #endif
 
-   E. Save your changes and close the file
+   F. Save your changes and close the file
 
 2. Now open irRecv.cpp and make the following change:
 
-   A. In the function IRrecv::decode(), add:
-      #ifdef DECODE_NEC
-          DBG_PRINTLN("Attempting Shuzu decode");
-          if (decodeShuzu(results))  return true ;
+   A. In IRrecv::decoderTable[], add:
+      #if DECODE_SHUZU
+          { SHUZU,  0,  0,  irWindowsShuzu,  &IRrecv::decodeShuzu },
+      #endif
+      and add DECODE_SHUZU to IR_DECODERS in IRremote.h.  If another decoder
+      can take Shuzu codes (or the other way round), list the later one's
+      type in the 'after' field of the other, so IR_ADAPT_ORDER keeps them
+      in that order.
+
+   B. Above it, with the other header windows, add:
+      #if DECODE_SHUZU
+          extern const irwindow_t  irWindowsShuzu[];
       #endif
 
-   B. Save your changes and close the file
+   C. Save your changes and close the file
 
 You will probably want to add your new protocol to the example sketch
 
@@ -145,13 +158,16 @@ void  IRsend::sendShuzu (unsigned long data,  int nbits)
 //+=============================================================================
 //
 #if DECODE_SHUZU
+// Header windows for the dispatcher in IRrecv::decode() : Header mark
+extern const irwindow_t  irWindowsShuzu[] = { IR_MARK_WINDOW(HDR_MARK), IR_WINDOW_END };
+
 bool  IRrecv::decodeShuzu (decode_results *results)
 {
 	unsigned long  data   = 0;  // Somewhere to build our code
 	int            offset = 1;  // Skip the Gap reading
 
 	// Check we have the right amount of data
-	if (irparams.rawlen != 1 + 2 + (2 * BITS) + 1)  return false ;
+	if (results->rawlen != 1 + 2 + (2 * BITS) + 1)  return false ;
 
 	// Check initial Mark+Space match
 	if (!MATCH_MARK (results->rawbuf[offset++], HDR_MARK ))  return false ;
@@ -18,74 +18,43 @@
 #define WHYNTER_ZERO_MARK    750
 #define WHYNTER_ZERO_SPACE   750
 
+//+=============================================================================
+// Timing for the codec engine (see irCodec.cpp)
+// A zero bit goes before the header, and after the footer mark
+//
+#if SEND_WHYNTER || DECODE_WHYNTER
+static const ircodec_t  irCodecWhynter PROGMEM = {
+	WHYNTER,  WHYNTER_BITS,  38,  0,
+	IR_PAIR(WHYNTER_ZERO_MARK, WHYNTER_ZERO_SPACE),
+	IR_PAIR(WHYNTER_HDR_MARK,  WHYNTER_HDR_SPACE),
+	IR_PAIR(WHYNTER_ONE_MARK,  WHYNTER_ONE_SPACE),
+	IR_PAIR(WHYNTER_ZERO_MARK, WHYNTER_ZERO_SPACE),
+	IR_PAIR(WHYNTER_ZERO_MARK, WHYNTER_ZERO_SPACE),
+	IR_NO_PAIR
+};
+#endif
+
 //+=============================================================================
 #if SEND_WHYNTER
 void  IRsend::sendWhynter (unsigned long data,  int nbits)
 {
-	// Set IR carrier frequency
-	enableIROut(38);
-
-	// Start
-	mark(WHYNTER_ZERO_MARK);
-	space(WHYNTER_ZERO_SPACE);
-
-	// Header
-	mark(WHYNTER_HDR_MARK);
-	space(WHYNTER_HDR_SPACE);
-
-	// Data
-	for (unsigned long  mask = 1UL << (nbits - 1);  mask;  mask >>= 1) {
-		if (data & mask) {
-			mark(WHYNTER_ONE_MARK);
-			space(WHYNTER_ONE_SPACE);
-		} else {
-			mark(WHYNTER_ZERO_MARK);
-			space(WHYNTER_ZERO_SPACE);
-		}
-	}
-
-	// Footer
-	mark(WHYNTER_ZERO_MARK);
-	space(WHYNTER_ZERO_SPACE);  // Always end with the LED off
+	sendCodec(&irCodecWhynter, data, nbits);
 }
 #endif
 
 //+=============================================================================
 #if DECODE_WHYNTER
-bool  IRrecv::decodeWhynter (decode_results *results)
-{
-	long  data   = 0;
-	int   offset = 1;  // skip initial space
+// Header windows for the dispatcher in IRrecv::decode() : Leading bit mark
+extern const irwindow_t  irWindowsWhynter[] = { IR_MARK_WINDOW(WHYNTER_BIT_MARK), IR_WINDOW_END };
 
-	// Check we have the right amount of data
-	if (irparams.rawlen < (2 * WHYNTER_BITS) + 6)  return false ;
-
-	// Sequence begins with a bit mark and a zero space
-	if (!MATCH_MARK (results->rawbuf[offset++], WHYNTER_BIT_MARK  ))  return false ;
-	if (!MATCH_SPACE(results->rawbuf[offset++], WHYNTER_ZERO_SPACE))  return false ;
-
-	// header mark and space
-	if (!MATCH_MARK (results->rawbuf[offset++], WHYNTER_HDR_MARK ))  return false ;
-	if (!MATCH_SPACE(results->rawbuf[offset++], WHYNTER_HDR_SPACE))  return false ;
-
-	// data bits
-	for (int i = 0;  i < WHYNTER_BITS;  i++) {
-		if (!MATCH_MARK(results->rawbuf[offset++], WHYNTER_BIT_MARK))  return false ;
-
-		if      (MATCH_SPACE(results->rawbuf[offset], WHYNTER_ONE_SPACE ))  data = (data << 1) | 1 ;
-		else if (MATCH_SPACE(results->rawbuf[offset], WHYNTER_ZERO_SPACE))  data = (data << 1) | 0 ;
-		else                                                                return false ;
-		offset++;
-	}
-
-	// trailing mark
-	if (!MATCH_MARK(results->rawbuf[offset], WHYNTER_BIT_MARK))  return false ;
+#if IR_ADAPT_LAG
+// Lag learning (see irlag_t) : Bit marks after the header
+extern const irlag_t  irLagWhynter = { 5, WHYNTER_BIT_MARK };
+#endif
 
-	// Success
-	results->bits = WHYNTER_BITS;
-	results->value = data;
-	results->decode_type = WHYNTER;
-	return true;
+bool  IRrecv::decodeWhynter (decode_results *results)
+{
+	return decodeCodec(results, &irCodecWhynter);
 }
 #endif
 